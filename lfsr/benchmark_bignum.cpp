@@ -0,0 +1,194 @@
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "bignum.h"
+#include "bignum_arithmetic.h"
+#include "lfsr_big.h"
+#include "lfsr_dynamic.h"
+
+namespace {
+template<int N>
+BigNum<N, std::uint64_t>
+random_bignum(std::mt19937_64& rng)
+{
+  BigNum<N, std::uint64_t> ret;
+  for (auto& d : ret.m_data) {
+    d = rng();
+  }
+  ret.mask_excess_bits();
+  return ret;
+}
+
+/// compares the vectorized operations (if enabled at build time) with the
+/// portable ones
+template<int N>
+void
+benchmark_bit_operations()
+{
+  std::mt19937_64 rng(N);
+  auto a = random_bignum<N>(rng);
+  const auto b = random_bignum<N>(rng);
+  const std::string suffix = ", N=" + std::to_string(N);
+  // keep_memory makes the compiler assume a and b change between the
+  // iterations, otherwise it hoists the work out of the benchmark loop
+  auto* pa = &a;
+  auto* pb = &b;
+
+  BENCHMARK("popcount" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    return a.popcount();
+  };
+  BENCHMARK("popcount generic" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    return detail::popcount_generic(a.m_data);
+  };
+  BENCHMARK("masked parity" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    return a.masked_parity(b);
+  };
+  BENCHMARK("masked parity generic" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    return detail::masked_parity_generic(a.m_data, b.m_data);
+  };
+  BENCHMARK("xor" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    a.xor_with(b);
+    return a.m_data[0];
+  };
+  BENCHMARK("shift right 13 bits" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pb);
+    auto c = b;
+    c.shift_right(13);
+    return c;
+  };
+  BENCHMARK("shift right 13 bits generic" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pb);
+    auto c = b;
+    detail::shift_right_generic(c.m_data, 13);
+    return c;
+  };
+  BENCHMARK("shift left 13 bits" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pb);
+    auto c = b;
+    c.shift_left(13);
+    return c;
+  };
+}
+
+/// the cost of one step of the register depends on the number of limbs
+template<int N, typename Limb>
+void
+benchmark_step(const std::string& limbname)
+{
+  BigLFSR<N, Limb> lfsr;
+  auto* p = &lfsr;
+  BENCHMARK("next() 1000 times, N=" + std::to_string(N) + ", " + limbname)
+  {
+    Catch::Benchmark::keep_memory(p);
+    for (int i = 0; i < 1000; ++i) {
+      lfsr.next();
+    }
+    return lfsr.state();
+  };
+}
+
+template<int N>
+void
+benchmark_step_all_limbs()
+{
+  benchmark_step<N, std::uint8_t>("uint8");
+  benchmark_step<N, std::uint16_t>("uint16");
+  benchmark_step<N, std::uint32_t>("uint32");
+  benchmark_step<N, std::uint64_t>("uint64");
+}
+
+/// the full product, with and without karatsuba
+template<int N>
+void
+benchmark_multiply()
+{
+  std::mt19937_64 rng(N);
+  const auto a = random_bignum<N>(rng);
+  const auto b = random_bignum<N>(rng);
+  const std::string suffix = ", N=" + std::to_string(N);
+  constexpr auto n = BigNum<N, std::uint64_t>::LimbCount;
+  auto* pa = &a;
+
+  BENCHMARK("multiply" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    return multiply(a, b);
+  };
+  BENCHMARK("multiply schoolbook" + suffix)
+  {
+    Catch::Benchmark::keep_memory(pa);
+    BigNum<2 * N, std::uint64_t> r;
+    detail::multiply_schoolbook<n>(
+      a.m_data.data(), b.m_data.data(), r.m_data.data());
+    return r;
+  };
+}
+} // namespace
+
+TEST_CASE("Benchmark bignum bit operations", "[!benchmark]")
+{
+  benchmark_bit_operations<128>();
+  benchmark_bit_operations<256>();
+  benchmark_bit_operations<512>();
+  benchmark_bit_operations<1024>();
+  benchmark_bit_operations<2048>();
+  benchmark_bit_operations<4096>();
+}
+
+TEST_CASE("Benchmark lfsr step by limb type", "[!benchmark]")
+{
+  benchmark_step_all_limbs<32>();
+  benchmark_step_all_limbs<64>();
+  benchmark_step_all_limbs<168>();
+  benchmark_step_all_limbs<521>();
+}
+
+TEST_CASE("Benchmark DynamicLFSR output", "[!benchmark]")
+{
+  std::vector<std::byte> out(1 << 16);
+  for (const std::size_t n : { 32, 64, 168 }) {
+    const std::string suffix = " 64 KiB, N=" + std::to_string(n);
+    DynamicLFSR lfsr(n);
+    BENCHMARK("fill" + suffix)
+    {
+      lfsr.fill(out);
+      return out[0];
+    };
+    BENCHMARK("next() per bit" + suffix)
+    {
+      unsigned acc = 0;
+      for (std::size_t i = 0; i < 8 * out.size(); ++i) {
+        acc ^= static_cast<unsigned>(lfsr.state()[0]);
+        lfsr.next();
+      }
+      return acc;
+    };
+  }
+}
+
+TEST_CASE("Benchmark bignum multiplication", "[!benchmark]")
+{
+  benchmark_multiply<1024>();
+  benchmark_multiply<1536>();
+  benchmark_multiply<2048>();
+  benchmark_multiply<4096>();
+}
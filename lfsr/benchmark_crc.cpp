@@ -0,0 +1,84 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "clmul_crc.h"
+#include "lfsr_big.h"
+#include "lfsr_polynomial.h"
+
+namespace {
+// large enough to measure throughput, small enough to stay in cache
+std::vector<std::byte>
+make_buffer()
+{
+  std::vector<std::byte> data(1 << 20);
+  std::mt19937_64 rng;
+  for (auto& b : data) {
+    b = static_cast<std::byte>(rng());
+  }
+  return data;
+}
+} // namespace
+
+TEST_CASE("Benchmark crc over 1 MiB", "[!benchmark]")
+{
+  const auto data = make_buffer();
+
+  BENCHMARK("N=32")
+  {
+    ClmulCrc<32> crc(feedback_modulus<32>());
+    crc.update(data);
+    return crc.value();
+  };
+  BENCHMARK("N=64")
+  {
+    ClmulCrc<64> crc(feedback_modulus<64>());
+    crc.update(data);
+    return crc.value();
+  };
+  BENCHMARK("N=127")
+  {
+    ClmulCrc<127> crc(feedback_modulus<127>());
+    crc.update(data);
+    return crc.value();
+  };
+  BENCHMARK("N=168")
+  {
+    ClmulCrc<168> crc(feedback_modulus<168>());
+    crc.update(data);
+    return crc.value();
+  };
+}
+
+TEST_CASE("Benchmark advancing a big LFSR", "[!benchmark]")
+{
+  BENCHMARK("next() 10000 times, N=168")
+  {
+    BigLFSR<168> lfsr;
+    for (int i = 0; i < 10000; ++i) {
+      lfsr.next();
+    }
+    return lfsr.state();
+  };
+  BENCHMARK("next(10000), N=168")
+  {
+    BigLFSR<168> lfsr;
+    lfsr.next(10000);
+    return lfsr.state();
+  };
+  BENCHMARK("advance(10000), N=168")
+  {
+    BigLFSR<168> lfsr;
+    lfsr.advance(10000);
+    return lfsr.state();
+  };
+  BENCHMARK("advance(2^63), N=168")
+  {
+    BigLFSR<168> lfsr;
+    lfsr.advance(1ULL << 63);
+    return lfsr.state();
+  };
+}
@@ -1,17 +1,113 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <bit>
 #include <cassert>
+#include <compare>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <limits>
+#include <type_traits>
 #include <utility>
 
+#include "bignum_simd.h"
+#include "integerselect.h"
+
+namespace detail {
+// portable versions of the bit operations in BigNum. the vectorized versions
+// in bignum_simd.h are used instead for 64 bit limbs, outside of constant
+// evaluation.
+
+template<typename Limb, std::size_t Count>
+constexpr int
+popcount_generic(const std::array<Limb, Count>& a)
+{
+  int ret = 0;
+  for (auto& d : a) {
+    ret += std::popcount(d);
+  }
+  return ret;
+}
+
+template<typename Limb, std::size_t Count>
+constexpr bool
+masked_parity_generic(const std::array<Limb, Count>& a,
+                      const std::array<Limb, Count>& mask)
+{
+  Limb acc{};
+  for (std::size_t i = 0; i < Count; ++i) {
+    acc ^= a[i] & mask[i];
+  }
+  return std::popcount(acc) & 1;
+}
+
+/// shifts towards the lsb, with whole limb moves and one funnel shift
+template<typename Limb, std::size_t Count>
+constexpr void
+shift_right_generic(std::array<Limb, Count>& a, const std::size_t n)
+{
+  constexpr std::size_t BitsPerLimb = std::numeric_limits<Limb>::digits;
+  const std::size_t limbs = n / BitsPerLimb;
+  const std::size_t bits = n % BitsPerLimb;
+  for (std::size_t i = 0; i < Count; ++i) {
+    Limb v{};
+    if (i + limbs < Count) {
+      v = static_cast<Limb>(a[i + limbs] >> bits);
+    }
+    if (bits != 0 && i + limbs + 1 < Count) {
+      v |= static_cast<Limb>(a[i + limbs + 1] << (BitsPerLimb - bits));
+    }
+    a[i] = v;
+  }
+}
+
+/// shifts towards the msb, bits shifted out of the top limb are discarded
+template<typename Limb, std::size_t Count>
+constexpr void
+shift_left_generic(std::array<Limb, Count>& a, const std::size_t n)
+{
+  constexpr std::size_t BitsPerLimb = std::numeric_limits<Limb>::digits;
+  const std::size_t limbs = n / BitsPerLimb;
+  const std::size_t bits = n % BitsPerLimb;
+  for (std::size_t i = Count; i > 0; --i) {
+    const std::size_t dst = i - 1;
+    Limb v{};
+    if (dst >= limbs) {
+      v = static_cast<Limb>(a[dst - limbs] << bits);
+      if (bits != 0 && dst >= limbs + 1) {
+        v |= static_cast<Limb>(a[dst - limbs - 1] >> (BitsPerLimb - bits));
+      }
+    }
+    a[dst] = v;
+  }
+}
+
+/// one limb of the smallest type that fits, otherwise as wide limbs as
+/// possible since the loops in BigNum run once per limb
+template<int Nbits>
+struct DefaultLimb
+{
+  using type = std::uint64_t;
+};
+template<int Nbits>
+requires fitsin64<Nbits>
+struct DefaultLimb<Nbits>
+{
+  using type = SelectInteger_t<Nbits>;
+};
+} // namespace detail
+
+/// the limb type BigNum uses unless told otherwise
+template<int Nbits>
+using DefaultLimb_t = typename detail::DefaultLimb<Nbits>::type;
+
 /**
  * this is a bignum class with very limited functionality, just
  * the bare minimum to be able to use it for implementing large LFSR
  */
-template<int Nbits, typename Limb = unsigned int>
+template<int Nbits, typename Limb = DefaultLimb_t<Nbits>>
 struct BigNum
 {
   static constexpr std::size_t bitcount() { return Nbits; }
@@ -19,6 +115,11 @@ struct BigNum
   static inline constexpr int LimbCount =
     (Nbits + (BitsPerLimb - 1)) / BitsPerLimb;
   static inline constexpr int ExcessBits = LimbCount * BitsPerLimb - Nbits;
+  /// the bits of m_data.back() which are part of the value
+  static inline constexpr Limb TopMask =
+    ExcessBits > 0
+      ? static_cast<Limb>((Limb{ 1U } << (BitsPerLimb - ExcessBits)) - 1U)
+      : static_cast<Limb>(~Limb{});
 
   template<std::size_t... bits>
   constexpr int parity(std::index_sequence<bits...>) const
@@ -26,13 +127,36 @@ struct BigNum
     return ((ith_bit<bits>() + ...) & 0x1);
   }
 
+  /// use the functions in bignum_simd.h. below one vector of limbs, the
+  /// plain loops are faster.
+  static inline constexpr bool Vectorized =
+    std::is_same_v<Limb, std::uint64_t> && detail::simd::words_per_vector > 0 &&
+    static_cast<std::size_t>(LimbCount) >= detail::simd::words_per_vector;
+
   constexpr int popcount() const
   {
-    int ret = 0;
-    for (auto& d : m_data) {
-      ret += std::popcount(d);
+    const int excess = std::popcount(excess_bits());
+    if constexpr (Vectorized) {
+      if (!std::is_constant_evaluated()) {
+        return detail::simd::popcount_words(m_data.data(), LimbCount) - excess;
+      }
     }
-    return ret;
+    return detail::popcount_generic(m_data) - excess;
+  }
+
+  /// the parity of the bits which are set in mask, an inner product over
+  /// GF(2)
+  constexpr bool masked_parity(const BigNum& mask) const
+  {
+    const bool excess =
+      std::popcount(static_cast<Limb>(excess_bits() & mask.excess_bits())) & 1;
+    if constexpr (Vectorized) {
+      if (!std::is_constant_evaluated()) {
+        return detail::simd::masked_parity_words(
+                 m_data.data(), mask.m_data.data(), LimbCount) != excess;
+      }
+    }
+    return detail::masked_parity_generic(m_data, mask.m_data) != excess;
   }
 
   template<std::size_t bit>
@@ -41,7 +165,7 @@ struct BigNum
     static_assert(bit <= Nbits);
     constexpr auto limb = bit / BitsPerLimb;
     constexpr auto bitwithinlimb = bit - (bit / BitsPerLimb) * BitsPerLimb;
-    constexpr auto limbmask = 1U << bitwithinlimb;
+    constexpr auto limbmask = Limb{ 1U } << bitwithinlimb;
     return (m_data[limb] & limbmask);
   }
 
@@ -50,7 +174,7 @@ struct BigNum
     assert(bit <= Nbits);
     const auto limb = bit / BitsPerLimb;
     const auto bitwithinlimb = bit - (bit / BitsPerLimb) * BitsPerLimb;
-    const auto limbmask = 1U << bitwithinlimb;
+    const auto limbmask = Limb{ 1U } << bitwithinlimb;
     return (m_data[limb] & limbmask);
   }
 
@@ -59,40 +183,197 @@ struct BigNum
     assert(bit < Nbits);
     const auto limb = bit / BitsPerLimb;
     const auto bitwithinlimb = bit - (bit / BitsPerLimb) * BitsPerLimb;
-    const Limb limbmask = 1U << bitwithinlimb;
-    if (value) {
-      m_data[limb] |= limbmask;
-    } else {
-      m_data[limb] &= ~limbmask;
-    }
+    const Limb limbmask = Limb{ 1U } << bitwithinlimb;
+    // branch free, value is the random feedback bit when stepping an LFSR
+    m_data[limb] = static_cast<Limb>((m_data[limb] & ~limbmask) |
+                                     (Limb{ value } << bitwithinlimb));
   }
 
   // flips all bits
-  void complement_in_place()
+  constexpr void complement_in_place()
   {
     for (auto& d : m_data) {
       d = ~d;
     }
+  }
+
+  /// clears the bits above Nbits in the top limb
+  constexpr void mask_excess_bits()
+  {
     if constexpr (ExcessBits > 0) {
-      constexpr Limb mask = (Limb{ 1U } << (BitsPerLimb - ExcessBits)) - 1U;
-      m_data.back() &= mask;
+      m_data.back() &= TopMask;
     }
   }
 
+  /// a copy with the excess bits cleared
+  constexpr BigNum normalized() const
+  {
+    BigNum ret = *this;
+    ret.mask_excess_bits();
+    return ret;
+  }
+
+  /// m_data.back() without the excess bits
+  constexpr Limb top_limb() const
+  {
+    return static_cast<Limb>(m_data.back() & TopMask);
+  }
+
+  /// the excess bits of m_data.back(), in place
+  constexpr Limb excess_bits() const
+  {
+    return static_cast<Limb>(m_data.back() & ~TopMask);
+  }
+
   // right shift one bit
-  void shr_one_bit()
+  constexpr void shr_one_bit() { shift_right(1); }
+
+  /// shifts n bits towards the lsb, zeros are shifted in
+  constexpr void shift_right(const std::size_t n)
   {
-    for (std::size_t i = 0; i < m_data.size(); ++i) {
-      m_data[i] >>= 1;
-      if (i + 1 < m_data.size()) {
-        // get the top bit from the bottom bit of the next limb
-        m_data[i] |= (m_data[i + 1] << (BitsPerLimb - 1));
+    // this is where the excess bits would become visible
+    mask_excess_bits();
+    if constexpr (Vectorized) {
+      if (!std::is_constant_evaluated()) {
+        if (n >= Nbits) {
+          m_data = {};
+        } else {
+          detail::simd::shift_right_words(
+            m_data.data(), LimbCount, n / 64, static_cast<unsigned>(n % 64));
+        }
+        return;
       }
     }
+    detail::shift_right_generic(m_data, n);
   }
 
-  /// lsb is in the beginning. the topmost excess bits at m_data.back() are kept
-  /// zero.
+  /// shifts n bits towards the msb, bits shifted out at the top are lost
+  constexpr void shift_left(const std::size_t n)
+  {
+    if constexpr (Vectorized) {
+      if (!std::is_constant_evaluated()) {
+        if (n >= Nbits) {
+          m_data = {};
+        } else {
+          detail::simd::shift_left_words(
+            m_data.data(), LimbCount, n / 64, static_cast<unsigned>(n % 64));
+        }
+        return;
+      }
+    }
+    detail::shift_left_generic(m_data, n);
+  }
+
+  constexpr void xor_with(const BigNum& other)
+  {
+    combine(other, detail::simd::XorOp{});
+  }
+
+  constexpr void and_with(const BigNum& other)
+  {
+    combine(other, detail::simd::AndOp{});
+  }
+
+  constexpr void or_with(const BigNum& other)
+  {
+    combine(other, detail::simd::OrOp{});
+  }
+
+  constexpr BigNum& operator^=(const BigNum& other)
+  {
+    xor_with(other);
+    return *this;
+  }
+  constexpr BigNum& operator&=(const BigNum& other)
+  {
+    and_with(other);
+    return *this;
+  }
+  constexpr BigNum& operator|=(const BigNum& other)
+  {
+    or_with(other);
+    return *this;
+  }
+  constexpr BigNum& operator>>=(const std::size_t n)
+  {
+    shift_right(n);
+    return *this;
+  }
+  constexpr BigNum& operator<<=(const std::size_t n)
+  {
+    shift_left(n);
+    return *this;
+  }
+
+  friend constexpr BigNum operator^(BigNum a, const BigNum& b)
+  {
+    return a ^= b;
+  }
+  friend constexpr BigNum operator&(BigNum a, const BigNum& b)
+  {
+    return a &= b;
+  }
+  friend constexpr BigNum operator|(BigNum a, const BigNum& b)
+  {
+    return a |= b;
+  }
+  friend constexpr BigNum operator>>(BigNum a, const std::size_t n)
+  {
+    return a >>= n;
+  }
+  friend constexpr BigNum operator<<(BigNum a, const std::size_t n)
+  {
+    return a <<= n;
+  }
+  friend constexpr BigNum operator~(BigNum a)
+  {
+    a.complement_in_place();
+    return a;
+  }
+
+  constexpr bool operator==(const BigNum& other) const
+  {
+    return top_limb() == other.top_limb() &&
+           std::equal(m_data.begin(), m_data.end() - 1, other.m_data.begin());
+  }
+
+  /// compares the values as unsigned integers
+  constexpr std::strong_ordering operator<=>(const BigNum& other) const
+  {
+    if (top_limb() != other.top_limb()) {
+      return top_limb() <=> other.top_limb();
+    }
+    for (std::size_t i = m_data.size() - 1; i > 0; --i) {
+      if (m_data[i - 1] != other.m_data[i - 1]) {
+        return m_data[i - 1] <=> other.m_data[i - 1];
+      }
+    }
+    return std::strong_ordering::equal;
+  }
+
+  /// applies op limb by limb, vectorized if possible
+  template<typename Op>
+  constexpr void combine(const BigNum& other, const Op op)
+  {
+    if constexpr (Vectorized) {
+      if (!std::is_constant_evaluated()) {
+        detail::simd::combine_words(
+          m_data.data(), other.m_data.data(), LimbCount, op);
+        return;
+      }
+    }
+    for (std::size_t i = 0; i < m_data.size(); ++i) {
+      m_data[i] = op(m_data[i], other.m_data[i]);
+    }
+  }
+
+  /**
+   * lsb is in the beginning. the topmost excess bits at m_data.back() may be
+   * left dirty by complement_in_place, shift_left and the bitwise operators,
+   * so the hot paths do not have to mask after every operation. the member
+   * functions ignore them, but code reading m_data directly must call
+   * mask_excess_bits() or normalized() first.
+   */
   std::array<Limb, LimbCount> m_data{};
 };
 
@@ -104,14 +385,31 @@ requires requires
 std::uint64_t
 to_uint64(const BigNum<Nbits, Limb>& bignum)
 {
+  const auto clean = bignum.normalized();
   std::uint64_t ret{};
-  if constexpr (bignum.BitsPerLimb < 64) {
-    for (std::size_t i = 0; i < bignum.LimbCount; ++i) {
-      ret <<= bignum.BitsPerLimb;
-      ret |= bignum.m_data[bignum.LimbCount - 1 - i];
+  if constexpr (clean.BitsPerLimb < 64) {
+    for (std::size_t i = 0; i < clean.LimbCount; ++i) {
+      ret <<= clean.BitsPerLimb;
+      ret |= clean.m_data[clean.LimbCount - 1 - i];
     }
   } else {
-    ret = bignum.m_data[0];
+    ret = clean.m_data[0];
   }
   return ret;
 }
+
+/// hashes all limbs, so BigNum can be used as a key in unordered containers
+template<int Nbits, typename Limb>
+struct std::hash<BigNum<Nbits, Limb>>
+{
+  std::size_t operator()(const BigNum<Nbits, Limb>& bignum) const noexcept
+  {
+    std::uint64_t h = Nbits;
+    for (const auto d : bignum.normalized().m_data) {
+      // multiply with the golden ratio and fold, as in fibonacci hashing
+      h = (h ^ static_cast<std::uint64_t>(d)) * 0x9E3779B97F4A7C15ULL;
+      h ^= h >> 32;
+    }
+    return static_cast<std::size_t>(h);
+  }
+};
@@ -0,0 +1,310 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "bignum.h"
+
+/*
+ * fixed width unsigned arithmetic on BigNum. everything is constexpr and
+ * works on the stack, there are no allocations. the limbs are treated as the
+ * digits of a number in base 2^BitsPerLimb, least significant first.
+ */
+
+namespace detail {
+__extension__ typedef unsigned __int128 uint128;
+
+/// an unsigned type twice as wide as Limb, for products and division
+template<typename Limb>
+struct DoubleWidth;
+template<>
+struct DoubleWidth<std::uint8_t>
+{
+  using type = std::uint16_t;
+};
+template<>
+struct DoubleWidth<std::uint16_t>
+{
+  using type = std::uint32_t;
+};
+template<>
+struct DoubleWidth<std::uint32_t>
+{
+  using type = std::uint64_t;
+};
+template<>
+struct DoubleWidth<std::uint64_t>
+{
+  using type = uint128;
+};
+template<typename Limb>
+using DoubleWidth_t = typename DoubleWidth<Limb>::type;
+
+/// a + b + carry, updating carry
+template<typename Limb>
+constexpr Limb
+add_with_carry(const Limb a, const Limb b, bool& carry)
+{
+#if defined(__x86_64__)
+  if constexpr (std::is_same_v<Limb, std::uint64_t>) {
+    if (!std::is_constant_evaluated()) {
+      unsigned long long sum;
+      carry = _addcarry_u64(carry, a, b, &sum);
+      return sum;
+    }
+  }
+#endif
+  const Limb partial = static_cast<Limb>(a + b);
+  const Limb sum = static_cast<Limb>(partial + carry);
+  carry = partial < a || sum < partial;
+  return sum;
+}
+
+/// a - b - borrow, updating borrow
+template<typename Limb>
+constexpr Limb
+subtract_with_borrow(const Limb a, const Limb b, bool& borrow)
+{
+#if defined(__x86_64__)
+  if constexpr (std::is_same_v<Limb, std::uint64_t>) {
+    if (!std::is_constant_evaluated()) {
+      unsigned long long difference;
+      borrow = _subborrow_u64(borrow, a, b, &difference);
+      return difference;
+    }
+  }
+#endif
+  const Limb partial = static_cast<Limb>(a - b);
+  const Limb difference = static_cast<Limb>(partial - borrow);
+  borrow = a < b || partial < static_cast<Limb>(borrow);
+  return difference;
+}
+
+/// r[0..n) += a[0..m), with m <= n. returns the carry out of r.
+template<typename Limb>
+constexpr bool
+add_limbs(Limb* r, const std::size_t n, const Limb* a, const std::size_t m)
+{
+  bool carry = false;
+  std::size_t i = 0;
+  for (; i < m; ++i) {
+    r[i] = add_with_carry(r[i], a[i], carry);
+  }
+  for (; carry && i < n; ++i) {
+    r[i] = add_with_carry(r[i], Limb{}, carry);
+  }
+  return carry;
+}
+
+/// r[0..n) -= a[0..m), with m <= n. returns the borrow out of r.
+template<typename Limb>
+constexpr bool
+subtract_limbs(Limb* r,
+               const std::size_t n,
+               const Limb* a,
+               const std::size_t m)
+{
+  bool borrow = false;
+  std::size_t i = 0;
+  for (; i < m; ++i) {
+    r[i] = subtract_with_borrow(r[i], a[i], borrow);
+  }
+  for (; borrow && i < n; ++i) {
+    r[i] = subtract_with_borrow(r[i], Limb{}, borrow);
+  }
+  return borrow;
+}
+
+/// r[0..2n) = a[0..n) * b[0..n), quadratic
+template<std::size_t n, typename Limb>
+constexpr void
+multiply_schoolbook(const Limb* a, const Limb* b, Limb* r)
+{
+  using Wide = DoubleWidth_t<Limb>;
+  constexpr int BitsPerLimb = std::numeric_limits<Limb>::digits;
+  std::fill(r, r + 2 * n, Limb{});
+  for (std::size_t i = 0; i < n; ++i) {
+    Limb carry{};
+    for (std::size_t j = 0; j < n; ++j) {
+      // can not overflow: (2^B-1)^2 + 2(2^B-1) = 2^2B-1
+      const Wide t = Wide{ a[i] } * b[j] + r[i + j] + carry;
+      r[i + j] = static_cast<Limb>(t);
+      carry = static_cast<Limb>(t >> BitsPerLimb);
+    }
+    r[i + n] = carry;
+  }
+}
+
+/// below this many limbs, karatsuba is slower than schoolbook
+inline constexpr std::size_t KaratsubaThreshold = 24;
+
+/**
+ * r[0..2n) = a[0..n) * b[0..n). splits a=a1*X+a0 and b=b1*X+b0 and computes
+ * a*b = a1*b1*X^2 + ((a0+a1)(b0+b1) - a0*b0 - a1*b1)*X + a0*b0 with three
+ * half size products instead of four. the recursion depth is known at
+ * compile time, so all temporaries live on the stack. small sizes fall back
+ * to schoolbook multiplication.
+ */
+template<std::size_t n, typename Limb>
+constexpr void
+multiply_karatsuba(const Limb* a, const Limb* b, Limb* r)
+{
+  if constexpr (n < KaratsubaThreshold) {
+    multiply_schoolbook<n>(a, b, r);
+  } else {
+    constexpr std::size_t lo = n / 2;
+    constexpr std::size_t hi = n - lo;
+
+    // a0*b0 goes to r[0..2lo), a1*b1 to r[2lo..2n)
+    multiply_karatsuba<lo>(a, b, r);
+    multiply_karatsuba<hi>(a + lo, b + lo, r + 2 * lo);
+
+    // the sums have one extra limb for the carry
+    std::array<Limb, hi + 1> asum{};
+    std::array<Limb, hi + 1> bsum{};
+    std::copy(a + lo, a + n, asum.begin());
+    std::copy(b + lo, b + n, bsum.begin());
+    add_limbs(asum.data(), hi + 1, a, lo);
+    add_limbs(bsum.data(), hi + 1, b, lo);
+
+    std::array<Limb, 2 * (hi + 1)> middle{};
+    multiply_karatsuba<hi + 1>(asum.data(), bsum.data(), middle.data());
+    subtract_limbs(middle.data(), middle.size(), r, 2 * lo);
+    subtract_limbs(middle.data(), middle.size(), r + 2 * lo, 2 * hi);
+
+    // the middle term is less than 2^(2*hi*B+1), so the top limb of middle
+    // may be needed but never reaches past r[2n)
+    add_limbs(r + lo,
+              2 * n - lo,
+              middle.data(),
+              std::min(middle.size(), 2 * n - lo));
+  }
+}
+} // namespace detail
+
+/*
+ * the operands may have dirty excess bits, so the top limbs are handled
+ * separately with the excess bits masked. the results are always clean.
+ */
+
+/// a += b modulo 2^Nbits. returns true if the sum overflowed.
+template<int Nbits, typename Limb>
+constexpr bool
+add_in_place(BigNum<Nbits, Limb>& a, const BigNum<Nbits, Limb>& b)
+{
+  constexpr std::size_t n = BigNum<Nbits, Limb>::LimbCount;
+  bool carry =
+    detail::add_limbs(a.m_data.data(), n - 1, b.m_data.data(), n - 1);
+  a.m_data.back() =
+    detail::add_with_carry(a.top_limb(), b.top_limb(), carry);
+  // with excess bits, the carry ends up in them instead
+  const bool overflow = carry || a.excess_bits() != 0;
+  a.mask_excess_bits();
+  return overflow;
+}
+
+/// a -= b modulo 2^Nbits. returns true if b was larger than a.
+template<int Nbits, typename Limb>
+constexpr bool
+subtract_in_place(BigNum<Nbits, Limb>& a, const BigNum<Nbits, Limb>& b)
+{
+  constexpr std::size_t n = BigNum<Nbits, Limb>::LimbCount;
+  bool borrow =
+    detail::subtract_limbs(a.m_data.data(), n - 1, b.m_data.data(), n - 1);
+  a.m_data.back() =
+    detail::subtract_with_borrow(a.top_limb(), b.top_limb(), borrow);
+  a.mask_excess_bits();
+  return borrow;
+}
+
+/// the full product, which never overflows
+template<int Na, int Nb, typename Limb>
+constexpr BigNum<Na + Nb, Limb>
+multiply(const BigNum<Na, Limb>& a, const BigNum<Nb, Limb>& b)
+{
+  constexpr std::size_t n = std::max(BigNum<Na, Limb>::LimbCount,
+                                     BigNum<Nb, Limb>::LimbCount);
+  std::array<Limb, n> x{};
+  std::array<Limb, n> y{};
+  std::copy(a.m_data.begin(), a.m_data.end() - 1, x.begin());
+  std::copy(b.m_data.begin(), b.m_data.end() - 1, y.begin());
+  x[a.m_data.size() - 1] = a.top_limb();
+  y[b.m_data.size() - 1] = b.top_limb();
+  std::array<Limb, 2 * n> product{};
+  detail::multiply_karatsuba<n>(x.data(), y.data(), product.data());
+
+  BigNum<Na + Nb, Limb> ret;
+  std::copy(
+    product.begin(), product.begin() + ret.m_data.size(), ret.m_data.begin());
+  return ret;
+}
+
+/**
+ * divides a by a single limb in place and returns the remainder. divisor
+ * must not be zero.
+ */
+template<int Nbits, typename Limb>
+constexpr Limb
+divide_in_place(BigNum<Nbits, Limb>& a, const Limb divisor)
+{
+  using Wide = detail::DoubleWidth_t<Limb>;
+  constexpr int BitsPerLimb = BigNum<Nbits, Limb>::BitsPerLimb;
+  assert(divisor != 0);
+  a.mask_excess_bits();
+  Limb remainder{};
+  for (std::size_t i = a.m_data.size(); i > 0; --i) {
+    const Wide current = (Wide{ remainder } << BitsPerLimb) | a.m_data[i - 1];
+    a.m_data[i - 1] = static_cast<Limb>(current / divisor);
+    remainder = static_cast<Limb>(current % divisor);
+  }
+  return remainder;
+}
+
+/// the quotient and remainder of a divided by a single limb
+template<int Nbits, typename Limb>
+constexpr std::pair<BigNum<Nbits, Limb>, Limb>
+divide(BigNum<Nbits, Limb> a, const Limb divisor)
+{
+  const auto remainder = divide_in_place(a, divisor);
+  return { a, remainder };
+}
+
+template<int Nbits, typename Limb>
+constexpr BigNum<Nbits, Limb>
+operator+(BigNum<Nbits, Limb> a, const BigNum<Nbits, Limb>& b)
+{
+  add_in_place(a, b);
+  return a;
+}
+
+template<int Nbits, typename Limb>
+constexpr BigNum<Nbits, Limb>
+operator-(BigNum<Nbits, Limb> a, const BigNum<Nbits, Limb>& b)
+{
+  subtract_in_place(a, b);
+  return a;
+}
+
+/// the product modulo 2^Nbits, use multiply() for the full product
+template<int Nbits, typename Limb>
+constexpr BigNum<Nbits, Limb>
+operator*(const BigNum<Nbits, Limb>& a, const BigNum<Nbits, Limb>& b)
+{
+  const auto product = multiply(a, b);
+  BigNum<Nbits, Limb> ret;
+  std::copy(product.m_data.begin(),
+            product.m_data.begin() + ret.m_data.size(),
+            ret.m_data.begin());
+  ret.mask_excess_bits();
+  return ret;
+}
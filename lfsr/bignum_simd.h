@@ -0,0 +1,318 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__) &&                   \
+  defined(__AVX512VBMI2__)
+#include <immintrin.h>
+#define LFSR_BIGNUM_HAVE_AVX512 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define LFSR_BIGNUM_HAVE_AVX2 1
+#endif
+
+/*
+ * vectorized bit operations on arrays of 64 bit words, used by BigNum when
+ * the limbs are 64 bit. the AVX-512 versions need VPOPCNTDQ and VBMI2 (for
+ * the funnel shifts) and handle the tail with masked loads. the AVX2 versions
+ * finish with a scalar loop. without either, plain loops are used.
+ */
+
+namespace detail::simd {
+
+/// the number of words in a vector register, zero if there is no vector path
+#if LFSR_BIGNUM_HAVE_AVX512
+inline constexpr std::size_t words_per_vector = 8;
+#elif LFSR_BIGNUM_HAVE_AVX2
+inline constexpr std::size_t words_per_vector = 4;
+#else
+inline constexpr std::size_t words_per_vector = 0;
+#endif
+
+/// the bitwise operations, for vectors and for limbs of any type
+struct XorOp
+{
+#if LFSR_BIGNUM_HAVE_AVX512
+  __m512i operator()(__m512i x, __m512i y) const
+  {
+    return _mm512_xor_si512(x, y);
+  }
+#elif LFSR_BIGNUM_HAVE_AVX2
+  __m256i operator()(__m256i x, __m256i y) const
+  {
+    return _mm256_xor_si256(x, y);
+  }
+#endif
+  template<typename Word>
+  constexpr Word operator()(Word x, Word y) const
+  {
+    return static_cast<Word>(x ^ y);
+  }
+};
+
+struct AndOp
+{
+#if LFSR_BIGNUM_HAVE_AVX512
+  __m512i operator()(__m512i x, __m512i y) const
+  {
+    return _mm512_and_si512(x, y);
+  }
+#elif LFSR_BIGNUM_HAVE_AVX2
+  __m256i operator()(__m256i x, __m256i y) const
+  {
+    return _mm256_and_si256(x, y);
+  }
+#endif
+  template<typename Word>
+  constexpr Word operator()(Word x, Word y) const
+  {
+    return static_cast<Word>(x & y);
+  }
+};
+
+struct OrOp
+{
+#if LFSR_BIGNUM_HAVE_AVX512
+  __m512i operator()(__m512i x, __m512i y) const
+  {
+    return _mm512_or_si512(x, y);
+  }
+#elif LFSR_BIGNUM_HAVE_AVX2
+  __m256i operator()(__m256i x, __m256i y) const
+  {
+    return _mm256_or_si256(x, y);
+  }
+#endif
+  template<typename Word>
+  constexpr Word operator()(Word x, Word y) const
+  {
+    return static_cast<Word>(x | y);
+  }
+};
+
+/// a[i] = op(a[i], b[i]) for all i
+template<typename Op>
+inline void
+combine_words(std::uint64_t* a,
+              const std::uint64_t* b,
+              const std::size_t n,
+              const Op op)
+{
+  std::size_t i = 0;
+#if LFSR_BIGNUM_HAVE_AVX512
+  for (; i < n; i += 8) {
+    const __mmask8 m = n - i >= 8 ? 0xFF : (1U << (n - i)) - 1U;
+    const auto x = _mm512_maskz_loadu_epi64(m, a + i);
+    const auto y = _mm512_maskz_loadu_epi64(m, b + i);
+    _mm512_mask_storeu_epi64(a + i, m, op(x, y));
+  }
+#elif LFSR_BIGNUM_HAVE_AVX2
+  for (; i < n / 4 * 4; i += 4) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), op(x, y));
+  }
+#endif
+  // the masked avx-512 loop has already covered the tail
+#if !LFSR_BIGNUM_HAVE_AVX512
+  for (; i < n; ++i) {
+    a[i] = op(a[i], b[i]);
+  }
+#endif
+}
+
+inline int
+popcount_words(const std::uint64_t* a, const std::size_t n)
+{
+  std::size_t i = 0;
+  std::uint64_t ret = 0;
+#if LFSR_BIGNUM_HAVE_AVX512
+  auto acc = _mm512_setzero_si512();
+  for (; i < n; i += 8) {
+    const __mmask8 m = n - i >= 8 ? 0xFF : (1U << (n - i)) - 1U;
+    const auto v = _mm512_maskz_loadu_epi64(m, a + i);
+    acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+  }
+  // storing the lanes avoids a false -Wmaybe-uninitialized from gcc 12 in
+  // _mm512_reduce_add_epi64
+  alignas(64) std::uint64_t lanes[8];
+  _mm512_store_si512(lanes, acc);
+  for (const auto lane : lanes) {
+    ret += lane;
+  }
+#elif LFSR_BIGNUM_HAVE_AVX2
+  // count the bits of each nibble with a table lookup, then sum the bytes
+  const auto lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                       3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                       2, 3, 2, 3, 3, 4);
+  const auto lownibbles = _mm256_set1_epi8(0x0F);
+  auto acc = _mm256_setzero_si256();
+  for (; i < n / 4 * 4; i += 4) {
+    const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const auto lo = _mm256_and_si256(v, lownibbles);
+    const auto hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lownibbles);
+    const auto bytes = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                       _mm256_shuffle_epi8(lookup, hi));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+  }
+  const auto sum = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                 _mm256_extracti128_si256(acc, 1));
+  ret = static_cast<std::uint64_t>(_mm_cvtsi128_si64(sum)) +
+        static_cast<std::uint64_t>(_mm_extract_epi64(sum, 1));
+#endif
+  // the masked avx-512 loop has already covered the tail
+#if !LFSR_BIGNUM_HAVE_AVX512
+  for (; i < n; ++i) {
+    ret += static_cast<std::uint64_t>(std::popcount(a[i]));
+  }
+#endif
+  return static_cast<int>(ret);
+}
+
+/// the parity of popcount(a & mask), by xoring all words together first
+inline bool
+masked_parity_words(const std::uint64_t* a,
+                    const std::uint64_t* mask,
+                    const std::size_t n)
+{
+  std::size_t i = 0;
+  std::uint64_t acc = 0;
+#if LFSR_BIGNUM_HAVE_AVX512
+  auto vacc = _mm512_setzero_si512();
+  for (; i < n; i += 8) {
+    const __mmask8 m = n - i >= 8 ? 0xFF : (1U << (n - i)) - 1U;
+    // 0x78 is vacc ^ (x & y)
+    vacc = _mm512_ternarylogic_epi64(vacc,
+                                     _mm512_maskz_loadu_epi64(m, a + i),
+                                     _mm512_maskz_loadu_epi64(m, mask + i),
+                                     0x78);
+  }
+  alignas(64) std::uint64_t lanes[8];
+  _mm512_store_si512(lanes, vacc);
+  for (const auto lane : lanes) {
+    acc ^= lane;
+  }
+#elif LFSR_BIGNUM_HAVE_AVX2
+  auto vacc = _mm256_setzero_si256();
+  for (; i < n / 4 * 4; i += 4) {
+    const auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+    const auto y =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mask + i));
+    vacc = _mm256_xor_si256(vacc, _mm256_and_si256(x, y));
+  }
+  const auto quarter = _mm_xor_si128(_mm256_castsi256_si128(vacc),
+                                     _mm256_extracti128_si256(vacc, 1));
+  acc = static_cast<std::uint64_t>(_mm_cvtsi128_si64(quarter)) ^
+        static_cast<std::uint64_t>(_mm_extract_epi64(quarter, 1));
+#endif
+  // the masked avx-512 loop has already covered the tail
+#if !LFSR_BIGNUM_HAVE_AVX512
+  for (; i < n; ++i) {
+    acc ^= a[i] & mask[i];
+  }
+#endif
+  return std::popcount(acc) & 1;
+}
+
+/**
+ * a[i] = the 64 bits starting at bit "bits" of a[i+words]:a[i+words+1], for
+ * all i. the top words are filled with zeros. bits must be less than 64.
+ * writing in ascending order only overwrites words which already have been
+ * read.
+ */
+inline void
+shift_right_words(std::uint64_t* a,
+                  const std::size_t n,
+                  const std::size_t words,
+                  const unsigned bits)
+{
+  std::size_t i = 0;
+  if (words < n) {
+    // the last word has no upper neighbour, it is handled below
+    const std::size_t full = n - words - 1;
+#if LFSR_BIGNUM_HAVE_AVX512
+    const auto count = _mm512_set1_epi64(bits);
+    for (; i + 8 <= full; i += 8) {
+      const auto lo = _mm512_loadu_si512(a + i + words);
+      const auto hi = _mm512_loadu_si512(a + i + words + 1);
+      _mm512_storeu_si512(a + i, _mm512_shrdv_epi64(lo, hi, count));
+    }
+#elif LFSR_BIGNUM_HAVE_AVX2
+    // shifting by 64 gives zero, which takes care of bits == 0
+    const auto rcount = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const auto lcount = _mm_cvtsi32_si128(static_cast<int>(64 - bits));
+    for (; i + 4 <= full; i += 4) {
+      const auto lo =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + words));
+      const auto hi =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + words + 1));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i),
+                          _mm256_or_si256(_mm256_srl_epi64(lo, rcount),
+                                          _mm256_sll_epi64(hi, lcount)));
+    }
+#endif
+    for (; i < full; ++i) {
+      a[i] = a[i + words] >> bits;
+      if (bits != 0) {
+        a[i] |= a[i + words + 1] << (64 - bits);
+      }
+    }
+    a[i] = a[i + words] >> bits;
+    ++i;
+  }
+  for (; i < n; ++i) {
+    a[i] = 0;
+  }
+}
+
+/**
+ * the mirror of shift_right_words: a[i] gets a[i-words] shifted up, with the
+ * top bits of a[i-words-1] shifted in. processed in descending order.
+ */
+inline void
+shift_left_words(std::uint64_t* a,
+                 const std::size_t n,
+                 const std::size_t words,
+                 const unsigned bits)
+{
+  std::size_t i = n;
+  if (words < n) {
+    // a[words] has no lower neighbour, it is handled below
+    const std::size_t lowest = words + 1;
+#if LFSR_BIGNUM_HAVE_AVX512
+    const auto count = _mm512_set1_epi64(bits);
+    for (; i >= lowest + 8; i -= 8) {
+      const auto hi = _mm512_loadu_si512(a + i - 8 - words);
+      const auto lo = _mm512_loadu_si512(a + i - 8 - words - 1);
+      _mm512_storeu_si512(a + i - 8, _mm512_shldv_epi64(hi, lo, count));
+    }
+#elif LFSR_BIGNUM_HAVE_AVX2
+    const auto lcount = _mm_cvtsi32_si128(static_cast<int>(bits));
+    const auto rcount = _mm_cvtsi32_si128(static_cast<int>(64 - bits));
+    for (; i >= lowest + 4; i -= 4) {
+      const auto hi = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(a + i - 4 - words));
+      const auto lo = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(a + i - 4 - words - 1));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i - 4),
+                          _mm256_or_si256(_mm256_sll_epi64(hi, lcount),
+                                          _mm256_srl_epi64(lo, rcount)));
+    }
+#endif
+    for (; i > lowest; --i) {
+      a[i - 1] = a[i - 1 - words] << bits;
+      if (bits != 0) {
+        a[i - 1] |= a[i - 2 - words] >> (64 - bits);
+      }
+    }
+    a[words] = a[0] << bits;
+    i = words;
+  }
+  for (; i > 0; --i) {
+    a[i - 1] = 0;
+  }
+}
+
+} // namespace detail::simd
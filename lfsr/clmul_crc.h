@@ -0,0 +1,191 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#if defined(__PCLMUL__) && defined(__SSSE3__)
+#include <immintrin.h>
+#define LFSR_CRC_HAVE_PCLMUL 1
+#endif
+
+#include "gf2poly.h"
+
+/**
+ * computes a CRC-like checksum M(x)*x^n mod P for a message M, using folding
+ * with carry-less multiplication.
+ *
+ * the message is read msb first (not reflected), with initial value zero and
+ * no final xor. for instance P=x^16+x^12+x^5+1 gives CRC-16/XMODEM.
+ *
+ * the accumulator holds Lanes words which are not reduced. each block of Lanes
+ * words is folded in by multiplying every word with x^(64*(j+Lanes)) mod P,
+ * which are Lanes*Words independent multiplications. the dependency chain is
+ * only one multiplication deep per block, so the throughput is bound by the
+ * carry-less multiplier and not its latency.
+ */
+template<int N>
+class ClmulCrc
+{
+public:
+  using Modulus = Gf2Modulus<N>;
+  using Element = typename Modulus::Element;
+  static constexpr int Words = Modulus::Words;
+  /// an even number of words, so they can be paired in vector registers
+  static constexpr int Lanes = (std::max(Words + 1, 8) + 1) / 2 * 2;
+
+  explicit ClmulCrc(const Modulus& modulus)
+    : m_modulus(modulus)
+  {
+    for (int j = 0; j < Lanes; ++j) {
+      m_fold[j] =
+        m_modulus.x_to_the(static_cast<std::uint64_t>(64) * (j + Lanes));
+    }
+  }
+
+  void reset() { m_acc = {}; }
+
+  void update(std::span<const std::byte> data)
+  {
+    constexpr std::size_t blocksize = Lanes * sizeof(std::uint64_t);
+    const std::size_t nblocks = data.size() / blocksize;
+    fold_blocks(data.data(), nblocks);
+    data = data.subspan(nblocks * blocksize);
+    while (data.size() >= sizeof(std::uint64_t)) {
+      append(load_be(data.data()), 64);
+      data = data.subspan(sizeof(std::uint64_t));
+    }
+    if (!data.empty()) {
+      std::uint64_t tail = 0;
+      for (const auto b : data) {
+        tail = (tail << 8) | std::to_integer<std::uint64_t>(b);
+      }
+      append(tail, 8 * static_cast<int>(data.size()));
+    }
+  }
+
+  /// the checksum of everything passed to update() since the last reset
+  Element value() const
+  {
+    const auto remainder = m_modulus.reduce(m_acc);
+    // x^n mod P is the lower part of P
+    return m_modulus.multiply(remainder, m_modulus.low());
+  }
+
+private:
+  static std::uint64_t load_be(const std::byte* p)
+  {
+    std::uint64_t ret;
+    std::memcpy(&ret, p, sizeof(ret));
+    if constexpr (std::endian::native == std::endian::little) {
+      ret = __builtin_bswap64(ret);
+    }
+    return ret;
+  }
+
+#if LFSR_CRC_HAVE_PCLMUL
+  /**
+   * the same as the portable version, but keeps the accumulator in vector
+   * registers with two words in each, so one PCLMULQDQ operates on a word
+   * pair without moving data between general purpose and vector registers.
+   */
+  void fold_blocks(const std::byte* p, std::size_t nblocks)
+  {
+    constexpr int Pairs = Lanes / 2;
+    __m128i acc[Pairs];
+    __m128i fold[Pairs][Words];
+    for (int q = 0; q < Pairs; ++q) {
+      acc[q] =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_acc[2 * q]));
+      for (int w = 0; w < Words; ++w) {
+        fold[q][w] = _mm_set_epi64x(
+          static_cast<long long>(m_fold[2 * q + 1].m_data[w]),
+          static_cast<long long>(m_fold[2 * q].m_data[w]));
+      }
+    }
+    // reversing all 16 bytes gives two big endian words in swapped order,
+    // which is what the accumulator wants
+    const __m128i reverse =
+      _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    for (; nblocks > 0; --nblocks) {
+      __m128i next[Pairs];
+      for (int q = 0; q < Pairs; ++q) {
+        next[q] = _mm_shuffle_epi8(
+          _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(p + 16 * (Pairs - 1 - q))),
+          reverse);
+      }
+      for (int w = 0; w < Words; ++w) {
+        __m128i t = _mm_setzero_si128();
+        for (int q = 0; q < Pairs; ++q) {
+          const auto& k = fold[q][w];
+          t = _mm_xor_si128(t, _mm_clmulepi64_si128(acc[q], k, 0x00));
+          t = _mm_xor_si128(t, _mm_clmulepi64_si128(acc[q], k, 0x11));
+        }
+        // t holds words w and w+1
+        if (w % 2 == 0) {
+          next[w / 2] = _mm_xor_si128(next[w / 2], t);
+        } else {
+          next[w / 2] = _mm_xor_si128(next[w / 2], _mm_slli_si128(t, 8));
+          next[w / 2 + 1] =
+            _mm_xor_si128(next[w / 2 + 1], _mm_srli_si128(t, 8));
+        }
+      }
+      for (int q = 0; q < Pairs; ++q) {
+        acc[q] = next[q];
+      }
+      p += 16 * Pairs;
+    }
+    for (int q = 0; q < Pairs; ++q) {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&m_acc[2 * q]), acc[q]);
+    }
+  }
+#else
+  /// acc = acc*x^(64*Lanes) + block, the first word being the most significant
+  void fold_blocks(const std::byte* p, std::size_t nblocks)
+  {
+    for (; nblocks > 0; --nblocks) {
+      std::array<std::uint64_t, Lanes> next{};
+      for (int j = 0; j < Lanes; ++j) {
+        for (int w = 0; w < Words; ++w) {
+          const auto [lo, hi] = clmul(m_acc[j], m_fold[j].m_data[w]);
+          next[w] ^= lo;
+          next[w + 1] ^= hi;
+        }
+      }
+      for (int i = 0; i < Lanes; ++i) {
+        next[Lanes - 1 - i] ^= load_be(p + i * sizeof(std::uint64_t));
+      }
+      m_acc = next;
+      p += Lanes * sizeof(std::uint64_t);
+    }
+  }
+#endif
+
+  /// acc = acc*x^nbits + value, where value has at most nbits bits
+  void append(const std::uint64_t value, const int nbits)
+  {
+    const std::uint64_t overflow = m_acc[Lanes - 1] >> (64 - nbits);
+    for (int i = Lanes - 1; i > 0; --i) {
+      m_acc[i] = nbits == 64 ? m_acc[i - 1]
+                             : (m_acc[i] << nbits) |
+                                 (m_acc[i - 1] >> (64 - nbits));
+    }
+    m_acc[0] = (nbits == 64 ? 0 : m_acc[0] << nbits) | value;
+    // the overflow sits at x^(64*Lanes)
+    for (int w = 0; w < Words; ++w) {
+      const auto [lo, hi] = clmul(overflow, m_fold[0].m_data[w]);
+      m_acc[w] ^= lo;
+      m_acc[w + 1] ^= hi;
+    }
+  }
+
+  Modulus m_modulus;
+  /// x^(64*(j+Lanes)) mod P
+  std::array<Element, Lanes> m_fold;
+  std::array<std::uint64_t, Lanes> m_acc{};
+};
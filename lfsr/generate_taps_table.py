@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+"""
+generates lfsr_taps_table.h from lfsr_taps.txt
+
+the table is stored as packed arrays, sorted on the register size so the
+lookup in lfsr_coefficients.h is a binary search instead of a linear scan.
+the leading tap is not stored since it always equals the register size.
+
+usage: generate_taps_table.py [lfsr_taps.txt] [lfsr_taps_table.h]
+"""
+
+import os
+import sys
+
+
+def parse(path):
+    entries = {}
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            taps = [int(t) for t in line.split()]
+            n = taps[0]
+            where = "%s:%d" % (path, lineno)
+            if len(taps) < 2:
+                sys.exit("%s: need at least two taps" % where)
+            if any(a <= b for a, b in zip(taps, taps[1:])) or taps[-1] <= 0:
+                sys.exit("%s: taps must be positive and descending" % where)
+            if n in entries:
+                sys.exit("%s: duplicate entry for N=%d" % (where, n))
+            if n >= 65536:
+                sys.exit("%s: N does not fit in the table" % where)
+            entries[n] = taps[1:]
+    return [(n, entries[n]) for n in sorted(entries)]
+
+
+def wrap(values, indent="  "):
+    lines = []
+    line = indent
+    for v in values:
+        item = "%d, " % v
+        if len(line) + len(item) > 80:
+            lines.append(line.rstrip())
+            line = indent
+        line += item
+    lines.append(line.rstrip())
+    return "\n".join(lines)
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    src = sys.argv[1] if len(sys.argv) > 1 else os.path.join(here, "lfsr_taps.txt")
+    dst = (
+        sys.argv[2] if len(sys.argv) > 2 else os.path.join(here, "lfsr_taps_table.h")
+    )
+    entries = parse(src)
+
+    nbits = [n for n, _ in entries]
+    first = [0]
+    data = []
+    for _, taps in entries:
+        data += taps
+        first.append(len(data))
+
+    with open(dst, "w") as f:
+        f.write(
+            """\
+// generated by generate_taps_table.py from lfsr_taps.txt, do not edit.
+#pragma once
+
+#include <cstdint>
+
+namespace detail::taps_table {
+/// the register sizes which have taps, in ascending order
+inline constexpr std::uint16_t nbits[] = {
+%s
+};
+
+/// the taps for nbits[i] are data[first[i]] to data[first[i+1]], excluding
+/// the leading tap which always is nbits[i]
+inline constexpr std::uint16_t first[] = {
+%s
+};
+
+inline constexpr std::uint16_t data[] = {
+%s
+};
+} // namespace detail::taps_table
+"""
+            % (wrap(nbits), wrap(first), wrap(data))
+        )
+
+
+if __name__ == "__main__":
+    main()
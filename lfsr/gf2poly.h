@@ -0,0 +1,260 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__PCLMUL__)
+#include <immintrin.h>
+#endif
+
+#include "bignum.h"
+
+/// the 128 bit product of a carry-less multiplication
+struct Clmul128
+{
+  std::uint64_t lo;
+  std::uint64_t hi;
+};
+
+namespace detail {
+/// portable carry-less multiplication, shift-and-xor without branches
+constexpr Clmul128
+clmul_portable(const std::uint64_t a, const std::uint64_t b)
+{
+  std::uint64_t lo = 0;
+  std::uint64_t hi = 0;
+  for (int i = 0; i < 64; ++i) {
+    const std::uint64_t mask = -((b >> i) & 1U);
+    lo ^= (a << i) & mask;
+    if (i > 0) {
+      hi ^= (a >> (64 - i)) & mask;
+    }
+  }
+  return { lo, hi };
+}
+
+/// reads 64 bits starting at an arbitrary bit offset. bits outside the array
+/// are read as zero.
+template<std::size_t Nwords>
+constexpr std::uint64_t
+extract64(const std::array<std::uint64_t, Nwords>& words, const int bitoffset)
+{
+  const int word = bitoffset / 64;
+  const int shift = bitoffset % 64;
+  std::uint64_t ret = 0;
+  if (word < static_cast<int>(Nwords)) {
+    ret = words[word] >> shift;
+  }
+  if (shift != 0 && word + 1 < static_cast<int>(Nwords)) {
+    ret |= words[word + 1] << (64 - shift);
+  }
+  return ret;
+}
+
+/// xors 64 bits in at an arbitrary bit offset. bits that fall outside the
+/// array are discarded.
+template<std::size_t Nwords>
+constexpr void
+xor64(std::array<std::uint64_t, Nwords>& words,
+      const int bitoffset,
+      const std::uint64_t value)
+{
+  const int word = bitoffset / 64;
+  const int shift = bitoffset % 64;
+  if (word < static_cast<int>(Nwords)) {
+    words[word] ^= value << shift;
+  }
+  if (shift != 0 && word + 1 < static_cast<int>(Nwords)) {
+    words[word + 1] ^= value >> (64 - shift);
+  }
+}
+} // namespace detail
+
+/**
+ * carry-less multiplication of two polynomials of degree < 64 over GF(2).
+ * uses PCLMULQDQ if the target supports it, otherwise a portable fallback.
+ */
+constexpr Clmul128
+clmul(const std::uint64_t a, const std::uint64_t b)
+{
+#if defined(__PCLMUL__)
+  if (!std::is_constant_evaluated()) {
+    const __m128i prod = _mm_clmulepi64_si128(
+      _mm_cvtsi64_si128(static_cast<long long>(a)),
+      _mm_cvtsi64_si128(static_cast<long long>(b)),
+      0x00);
+    return { static_cast<std::uint64_t>(_mm_cvtsi128_si64(prod)),
+             static_cast<std::uint64_t>(
+               _mm_cvtsi128_si64(_mm_unpackhi_epi64(prod, prod))) };
+  }
+#endif
+  return detail::clmul_portable(a, b);
+}
+
+/**
+ * arithmetic in GF(2)[x] modulo a polynomial P of degree n, where n <= N.
+ *
+ * elements are stored as BigNum<N, std::uint64_t>, with bit i being the
+ * coefficient for x^i. the modulus is given by its lower part P - x^n, the
+ * leading term is implicit.
+ *
+ * reduction is done 64 bits at a time with barrett reduction, which is exact
+ * for polynomials, so a multiplication costs two rounds of carry-less
+ * multiplications regardless of how many terms P has.
+ */
+template<int N>
+class Gf2Modulus
+{
+public:
+  using Element = BigNum<N, std::uint64_t>;
+  static constexpr int Words = Element::LimbCount;
+
+  constexpr explicit Gf2Modulus(const Element& low, const int degree = N)
+    : m_low(low)
+    , m_degree(degree)
+    , m_words((degree + 63) / 64)
+  {
+    assert(degree > 0 && degree <= N);
+    m_mu = compute_mu();
+  }
+
+  constexpr int degree() const { return m_degree; }
+
+  /// P - x^n, which is also x^n mod P
+  constexpr const Element& low() const { return m_low; }
+
+  constexpr Element one() const
+  {
+    Element ret;
+    ret.m_data[0] = 1;
+    return ret;
+  }
+
+  constexpr Element multiply(const Element& a, const Element& b) const
+  {
+    std::array<std::uint64_t, 2 * Words> product{};
+    for (int i = 0; i < m_words; ++i) {
+      for (int j = 0; j < m_words; ++j) {
+        const auto [lo, hi] = clmul(a.m_data[i], b.m_data[j]);
+        product[i + j] ^= lo;
+        product[i + j + 1] ^= hi;
+      }
+    }
+    return reduce(product);
+  }
+
+  /// squaring is linear over GF(2), it just spreads the bits out
+  constexpr Element square(const Element& a) const
+  {
+    std::array<std::uint64_t, 2 * Words> product{};
+    for (int i = 0; i < m_words; ++i) {
+      const auto [lo, hi] = clmul(a.m_data[i], a.m_data[i]);
+      product[2 * i] = lo;
+      product[2 * i + 1] = hi;
+    }
+    return reduce(product);
+  }
+
+  constexpr Element multiply_by_x(Element a) const
+  {
+    const int topbit = m_degree - 1;
+    const bool carry = (a.m_data[topbit / 64] >> (topbit % 64)) & 1U;
+    if constexpr (Words > 1) {
+      for (int i = m_words - 1; i > 0; --i) {
+        a.m_data[i] = (a.m_data[i] << 1) | (a.m_data[i - 1] >> 63);
+      }
+    }
+    a.m_data[0] <<= 1;
+    if (m_degree % 64 != 0) {
+      a.m_data[m_words - 1] &= ~(std::uint64_t{ 1U } << (m_degree % 64));
+    }
+    if (carry) {
+      for (int i = 0; i < m_words; ++i) {
+        a.m_data[i] ^= m_low.m_data[i];
+      }
+    }
+    return a;
+  }
+
+  /// x^k mod P, with left to right binary exponentiation
+  constexpr Element x_to_the(const std::uint64_t k) const
+  {
+    Element ret = one();
+    for (int bit = 63 - std::countl_zero(k); bit >= 0; --bit) {
+      ret = square(ret);
+      if ((k >> bit) & 1U) {
+        ret = multiply_by_x(ret);
+      }
+    }
+    return ret;
+  }
+
+  /**
+   * reduces a polynomial of arbitrary length modulo P.
+   * @param words lsb first, must be at least Words long
+   */
+  template<std::size_t Nwords>
+  constexpr Element reduce(std::array<std::uint64_t, Nwords> words) const
+  {
+    static_assert(Nwords >= Words);
+    // clear 64 bits at a time, starting from the top. a chunk c at bit n+64j
+    // is removed by subtracting q*P*x^(64j) where q=floor(c*x^n/P), which
+    // barrett reduction gives as floor(c*mu/x^64).
+    const int totalbits = static_cast<int>(Nwords) * 64;
+    for (int j = (totalbits - m_degree - 1) / 64; j >= 0; --j) {
+      const int offset = m_degree + 64 * j;
+      const std::uint64_t c = detail::extract64(words, offset);
+      if (c == 0) {
+        continue;
+      }
+      const std::uint64_t q = c ^ clmul(c, m_mu).hi;
+      detail::xor64(words, offset, q);
+      for (int i = 0; i < m_words; ++i) {
+        const auto [lo, hi] = clmul(q, m_low.m_data[i]);
+        detail::xor64(words, 64 * (i + j), lo);
+        detail::xor64(words, 64 * (i + j + 1), hi);
+      }
+      assert(detail::extract64(words, offset) == 0);
+    }
+    Element ret;
+    for (int i = 0; i < Words; ++i) {
+      ret.m_data[i] = words[i];
+    }
+    return ret;
+  }
+
+private:
+  /// mu=floor(x^(n+64)/P) - x^64. only the top 65 coefficients of P affect it.
+  constexpr std::uint64_t compute_mu() const
+  {
+    std::uint64_t t;
+    if (m_degree >= 64) {
+      t = detail::extract64(m_low.m_data, m_degree - 64);
+    } else {
+      t = m_low.m_data[0] << (64 - m_degree);
+    }
+    // long division of x^128 by x^64+t, keeping track of the remainder
+    // coefficients for x^64 and up
+    std::uint64_t remainder = t;
+    std::uint64_t quotient = 0;
+    for (int i = 63; i >= 0; --i) {
+      if ((remainder >> i) & 1U) {
+        quotient |= std::uint64_t{ 1U } << i;
+        remainder ^= std::uint64_t{ 1U } << i;
+        if (i > 0) {
+          remainder ^= t >> (64 - i);
+        }
+      }
+    }
+    return quotient;
+  }
+
+  Element m_low;
+  int m_degree;
+  /// the number of words needed for an element
+  int m_words;
+  std::uint64_t m_mu{};
+};
@@ -1,12 +1,14 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 
 #include "bignum.h"
 #include "lfsr_coefficients.h"
+#include "lfsr_polynomial.h"
 
 // the size of the shift register
-template<std::size_t N, typename Limb = unsigned int>
+template<std::size_t N, typename Limb = DefaultLimb_t<N>>
 class BigLFSR
 {
 
@@ -28,8 +30,61 @@ public:
     m_state.set_bit_to(N - 1, bit);
   }
 
+  /**
+   * steps the register as if next() was called steps times.
+   *
+   * the feedback for step j only reads bits j+N-tap of the current state, so
+   * up to min(taps) feedback bits can be computed at once by xoring shifted
+   * copies of the state. this costs one full width shift per tap for every
+   * min(taps) steps, instead of one per step.
+   */
+  void next(std::size_t steps)
+  {
+    constexpr auto taps = getTaps<N>();
+    while (steps > 0) {
+      const auto chunk = std::min(steps, MaxParallelSteps);
+      auto feedback = shifted_feedback(taps);
+      // feedback bit j becomes bit N-chunk+j, the rest is shifted out
+      feedback <<= N - chunk;
+      m_state >>= chunk;
+      m_state |= feedback;
+      steps -= chunk;
+    }
+  }
+
+  /**
+   * advances the register as if next() was called steps times.
+   *
+   * bit i of the state is s(t+i), and s(t+k) is the inner product of the
+   * current state with x^k mod P where P is the characteristic polynomial.
+   * this costs O(log(steps)) multiplications in GF(2)[x] instead of O(steps)
+   * calls to next().
+   */
+  void advance(const std::uint64_t steps)
+  {
+    static constexpr auto modulus = characteristic_modulus<N>();
+    using Element = typename decltype(modulus)::Element;
+
+    // next() leaves the excess bits dirty, they must not end up in current
+    const State clean = m_state.normalized();
+    Element current;
+    for (int i = 0; i < State::LimbCount; ++i) {
+      const auto bit = i * State::BitsPerLimb;
+      current.m_data[bit / 64] |= std::uint64_t{ clean.m_data[i] }
+                                  << (bit % 64);
+    }
+
+    auto r = modulus.x_to_the(steps);
+    State next;
+    for (std::size_t i = 0; i < N; ++i) {
+      next.set_bit_to(i, r.masked_parity(current));
+      r = modulus.multiply_by_x(r);
+    }
+    m_state = next;
+  }
+
   /// observe the state
-  State state() const { return m_state; }
+  State state() const { return m_state.normalized(); }
 
 private:
   template<std::size_t... ints>
@@ -37,5 +92,23 @@ private:
   {
     return std::index_sequence<(N - ints)...>{};
   }
+
+  template<std::size_t... ints>
+  static constexpr std::size_t smallest_tap(std::index_sequence<ints...>)
+  {
+    return std::min({ ints... });
+  }
+
+  /// the number of steps next(steps) computes in one go
+  static constexpr std::size_t MaxParallelSteps = smallest_tap(getTaps<N>());
+
+  /// bit j is the feedback for step j, for j < MaxParallelSteps
+  template<std::size_t... ints>
+  State shifted_feedback(std::index_sequence<ints...>) const
+  {
+    State ret;
+    ((ret ^= m_state >> (N - ints)), ...);
+    return ret;
+  }
   State m_state{};
 };
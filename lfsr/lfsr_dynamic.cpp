@@ -0,0 +1,137 @@
+#include "lfsr_dynamic.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "lfsr_big.h"
+#include "lfsr_small.h"
+
+namespace {
+/// writes bits lsb first into whole bytes
+class BitWriter
+{
+public:
+  explicit BitWriter(std::byte* out)
+    : m_out(out)
+  {
+  }
+
+  /// appends the n lowest bits of value, n <= 32
+  void append(const std::uint64_t value, const unsigned n)
+  {
+    m_acc |= (value & ((std::uint64_t{ 1 } << n) - 1U)) << m_fill;
+    m_fill += n;
+    while (m_fill >= 8) {
+      *m_out++ = static_cast<std::byte>(m_acc);
+      m_acc >>= 8;
+      m_fill -= 8;
+    }
+  }
+
+  /// appends the n lowest bits of value, n <= 64
+  void append_wide(const std::uint64_t value, const unsigned n)
+  {
+    if (n > 32) {
+      append(value, 32);
+      append(value >> 32, n - 32);
+    } else {
+      append(value, n);
+    }
+  }
+
+private:
+  std::byte* m_out;
+  std::uint64_t m_acc = 0;
+  unsigned m_fill = 0;
+};
+
+template<std::size_t N>
+class DynamicLFSRModel final : public detail::DynamicLFSRBase
+{
+  using LFSR = std::conditional_t<(N <= 64), SmallLFSR<N>, BigLFSR<N>>;
+
+public:
+  std::size_t size() const override { return N; }
+
+  void next(const std::size_t steps) override { m_lfsr.next(steps); }
+
+  std::vector<std::uint64_t> state() const override
+  {
+    std::vector<std::uint64_t> ret((N + 63) / 64);
+    if constexpr (N <= 64) {
+      ret[0] = m_lfsr.state();
+    } else {
+      const auto s = m_lfsr.state();
+      using State = decltype(s);
+      for (std::size_t i = 0; i < State::LimbCount; ++i) {
+        const auto bit = i * State::BitsPerLimb;
+        ret[bit / 64] |= std::uint64_t{ s.m_data[i] } << (bit % 64);
+      }
+    }
+    return ret;
+  }
+
+  /// the state holds the next N output bits, so they are taken N at a time
+  void fill(const std::span<std::byte> out) override
+  {
+    BitWriter writer(out.data());
+    std::size_t remaining = 8 * out.size();
+    while (remaining > 0) {
+      const auto nbits = std::min(remaining, N);
+      append_state(writer, nbits);
+      m_lfsr.next(nbits);
+      remaining -= nbits;
+    }
+  }
+
+private:
+  /// appends the nbits lowest bits of the state
+  void append_state(BitWriter& writer, const std::size_t nbits) const
+  {
+    if constexpr (N <= 64) {
+      writer.append_wide(m_lfsr.state(), static_cast<unsigned>(nbits));
+    } else {
+      const auto s = m_lfsr.state();
+      constexpr std::size_t BitsPerLimb = decltype(s)::BitsPerLimb;
+      for (std::size_t i = 0; i * BitsPerLimb < nbits; ++i) {
+        const auto n = std::min(BitsPerLimb, nbits - i * BitsPerLimb);
+        writer.append_wide(s.m_data[i], static_cast<unsigned>(n));
+      }
+    }
+  }
+
+  LFSR m_lfsr;
+};
+
+using Factory = std::unique_ptr<detail::DynamicLFSRBase> (*)();
+
+template<std::size_t N>
+std::unique_ptr<detail::DynamicLFSRBase>
+make_model()
+{
+  return std::make_unique<DynamicLFSRModel<N>>();
+}
+
+template<std::size_t... I>
+constexpr std::array<Factory, sizeof...(I)>
+make_factories(std::index_sequence<I...>)
+{
+  return { &make_model<DynamicLFSR::MinSize + I>... };
+}
+
+/// factories[n - MinSize] creates the model for size n
+constexpr auto factories = make_factories(
+  std::make_index_sequence<DynamicLFSR::MaxSize - DynamicLFSR::MinSize + 1>{});
+} // namespace
+
+DynamicLFSR::DynamicLFSR(const std::size_t n)
+{
+  if (n < MinSize || n > MaxSize) {
+    throw std::invalid_argument("no LFSR of size " + std::to_string(n));
+  }
+  m_impl = factories[n - MinSize]();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace detail {
+/// the interface DynamicLFSR forwards to, implemented in lfsr_dynamic.cpp
+class DynamicLFSRBase
+{
+public:
+  virtual ~DynamicLFSRBase() = default;
+  virtual std::size_t size() const = 0;
+  virtual void next(std::size_t steps) = 0;
+  virtual std::vector<std::uint64_t> state() const = 0;
+  virtual void fill(std::span<std::byte> out) = 0;
+};
+} // namespace detail
+
+/**
+ * an LFSR with the size chosen at runtime. the constructor picks a
+ * SmallLFSR<N> (up to 64 bits) or BigLFSR<N> from a table of precompiled
+ * specializations, and every call goes through a virtual function. use
+ * fill() to produce many bits per call, so the indirection is amortized.
+ */
+class DynamicLFSR
+{
+public:
+  static constexpr std::size_t MinSize = 3;
+  static constexpr std::size_t MaxSize = 168;
+
+  /// throws std::invalid_argument unless MinSize <= n <= MaxSize
+  explicit DynamicLFSR(std::size_t n);
+
+  std::size_t size() const { return m_impl->size(); }
+
+  void next() { m_impl->next(1); }
+
+  /// steps the register as if next() was called steps times
+  void next(std::size_t steps) { m_impl->next(steps); }
+
+  /// the state as 64 bit words, least significant first
+  std::vector<std::uint64_t> state() const { return m_impl->state(); }
+
+  /**
+   * fills out with the output sequence, which is bit 0 of the state before
+   * each step. the bits are packed lsb first, eight steps per byte, and
+   * consecutive calls continue the sequence.
+   */
+  void fill(std::span<std::byte> out) { m_impl->fill(out); }
+
+private:
+  std::unique_ptr<detail::DynamicLFSRBase> m_impl;
+};
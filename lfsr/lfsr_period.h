@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "bignum.h"
+#include "bignum_arithmetic.h"
+#include "gf2poly.h"
+#include "lfsr_big.h"
+#include "lfsr_polynomial.h"
+#include "mersenne_factors.h"
+#include "primitivity.h"
+
+/*
+ * verifies the period of an LFSR without storing the states. the state at
+ * time t is x^t times the initial state modulo the characteristic
+ * polynomial P, so the period is the order of x modulo P.
+ */
+
+/**
+ * the order of x modulo P of degree n, or nullopt if it does not divide
+ * 2^n-1 (then P is reducible). the order is found by starting from 2^n-1 and
+ * removing each prime factor p as long as x^(e/p) is still one.
+ * @throws std::invalid_argument if the factorization of 2^n-1 is not in
+ * mersenne_factors.h
+ */
+template<int N>
+std::optional<BigNum<N, std::uint64_t>>
+period_of(const Gf2Modulus<N>& m)
+{
+  const int n = m.degree();
+  const auto hexfactors = mersenne_factors(n);
+  if (!hexfactors) {
+    throw std::invalid_argument("the factorization of 2^n-1 is not known");
+  }
+  auto factors = parse_factors<N>(*hexfactors);
+  if (factors.empty()) {
+    // 2^n-1 is prime
+    factors.emplace_back();
+    for (int i = 0; i < n; ++i) {
+      factors.back().set_bit_to(i, true);
+    }
+  }
+
+  // x is invertible, so x^(2^n-1) == 1 is the same as x^(2^n) == x
+  const auto x = detail::x_of(m);
+  if (detail::repeated_square(m, x, n).m_data != x.m_data) {
+    return std::nullopt;
+  }
+  // a factor which can not be removed stays necessary when others are
+  // removed, so one pass is enough
+  for (std::size_t i = 0; i < factors.size();) {
+    auto y = x;
+    for (std::size_t j = 0; j < factors.size(); ++j) {
+      if (j != i) {
+        y = detail::power(m, y, factors[j]);
+      }
+    }
+    if (y.m_data == m.one().m_data) {
+      factors.erase(factors.begin() + static_cast<std::ptrdiff_t>(i));
+    } else {
+      ++i;
+    }
+  }
+  BigNum<N, std::uint64_t> period;
+  period.set_bit_to(0, true);
+  for (const auto& f : factors) {
+    period = period * f;
+  }
+  return period;
+}
+
+/// true if the taps of an N bit LFSR give the maximal period 2^N-1
+template<std::size_t N>
+bool
+has_maximal_period()
+{
+  const auto period = period_of(characteristic_modulus<N>());
+  return period && *period == ~BigNum<N, std::uint64_t>{};
+}
+
+/**
+ * counts the steps until BigLFSR<N> returns to its initial state, by
+ * stepping it. the possible periods 1..2^N-1 are split between the threads,
+ * and each thread jumps to the start of its range with advance(), so the
+ * memory use is O(1). this takes a few seconds per thread for N=32.
+ */
+template<std::size_t N>
+std::uint64_t
+count_period(const unsigned nthreads =
+               std::max(1U, std::thread::hardware_concurrency()))
+{
+  static_assert(N < 64, "stepping through 2^N states is not feasible");
+  constexpr std::uint64_t maxperiod = (std::uint64_t{ 1 } << N) - 1;
+  const auto initial = BigLFSR<N>{}.state();
+  const std::uint64_t chunk = (maxperiod + nthreads - 1) / nthreads;
+
+  // the smallest step count found to give back the initial state
+  std::atomic<std::uint64_t> best{ maxperiod + 1 };
+  auto worker = [&](const std::uint64_t first, const std::uint64_t last) {
+    BigLFSR<N> lfsr;
+    lfsr.advance(first);
+    for (std::uint64_t steps = first + 1; steps <= last; ++steps) {
+      lfsr.next();
+      if (lfsr.state() == initial) {
+        auto current = best.load();
+        while (steps < current && !best.compare_exchange_weak(current, steps)) {
+        }
+        return;
+      }
+      // another thread found a shorter period
+      if (steps % 65536 == 0 && steps >= best.load()) {
+        return;
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < nthreads; ++i) {
+    const auto first = std::min(maxperiod, i * chunk);
+    threads.emplace_back(worker, first, std::min(maxperiod, first + chunk));
+  }
+  worker(0, std::min(maxperiod, chunk));
+  for (auto& t : threads) {
+    t.join();
+  }
+  return best.load();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <utility>
+
+#include "gf2poly.h"
+#include "lfsr_coefficients.h"
+
+namespace detail {
+template<int N, std::size_t... taps>
+constexpr Gf2Modulus<N>
+feedback_modulus_impl(std::index_sequence<taps...>)
+{
+  typename Gf2Modulus<N>::Element low;
+  // the tap N is the implicit leading term
+  ((taps < static_cast<std::size_t>(N) ? low.set_bit_to(taps, true)
+                                       : void()),
+   ...);
+  low.set_bit_to(0, true);
+  return Gf2Modulus<N>(low);
+}
+
+template<int N, std::size_t... taps>
+constexpr Gf2Modulus<N>
+characteristic_modulus_impl(std::index_sequence<taps...>)
+{
+  typename Gf2Modulus<N>::Element low;
+  (low.set_bit_to(N - taps, true), ...);
+  return Gf2Modulus<N>(low);
+}
+} // namespace detail
+
+/**
+ * the feedback polynomial x^N + ... + 1 for the taps of an N bit LFSR, for
+ * instance x^16 + x^14 + x^13 + x^11 + 1 for N=16.
+ */
+template<int N>
+constexpr Gf2Modulus<N>
+feedback_modulus()
+{
+  return detail::feedback_modulus_impl<N>(getTaps<N>());
+}
+
+/**
+ * the characteristic polynomial of the sequence of states, which is the
+ * reciprocal of the feedback polynomial. bit i of the state at time t is
+ * s(t+i), and s obeys x^N = sum of x^(N-tap).
+ */
+template<int N>
+constexpr Gf2Modulus<N>
+characteristic_modulus()
+{
+  return detail::characteristic_modulus_impl<N>(getTaps<N>());
+}
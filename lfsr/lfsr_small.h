@@ -1,6 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <utility>
 
 #include "integerselect.h"
 #include "lfsr_coefficients.h"
@@ -46,13 +50,50 @@ public:
   void next()
   {
     constexpr auto m = mask();
-    const auto bit = __builtin_parity(m_state & m);
+    // __builtin_parity and int would truncate the state above 32 bits
+    const State bit = std::popcount(static_cast<State>(m_state & m)) & 1U;
     m_state = (m_state >> 1) | (bit << (N - 1));
   }
 
+  /**
+   * steps the register as if next() was called steps times, computing
+   * min(taps) feedback bits at once like BigLFSR::next(steps) does.
+   */
+  void next(std::size_t steps)
+  {
+    while (steps > 0) {
+      const auto chunk = std::min(steps, MaxParallelSteps);
+      const State feedback = shifted_feedback(taps{});
+      m_state = static_cast<State>(
+        ((m_state >> chunk) | (feedback << (N - chunk))) & ValueMask);
+      steps -= chunk;
+    }
+  }
+
   /// observe the state
   State state() const { return m_state; }
 
 private:
+  static constexpr State ValueMask =
+    N == std::numeric_limits<State>::digits
+      ? static_cast<State>(~State{})
+      : static_cast<State>((State{ 1U } << N) - 1U);
+
+  template<std::size_t... ints>
+  static constexpr std::size_t smallest_tap(std::index_sequence<ints...>)
+  {
+    return std::min({ ints... });
+  }
+
+  /// the number of steps next(steps) computes in one go
+  static constexpr std::size_t MaxParallelSteps = smallest_tap(taps{});
+
+  /// bit j is the feedback for step j, for j < MaxParallelSteps
+  template<std::size_t... ints>
+  State shifted_feedback(std::index_sequence<ints...>) const
+  {
+    return static_cast<State>((... ^ (m_state >> (N - ints))));
+  }
+
   State m_state = 1;
 };
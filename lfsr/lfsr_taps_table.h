@@ -0,0 +1,86 @@
+// generated by generate_taps_table.py from lfsr_taps.txt, do not edit.
+#pragma once
+
+#include <cstdint>
+
+namespace detail::taps_table {
+/// the register sizes which have taps, in ascending order
+inline constexpr std::uint16_t nbits[] = {
+  3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23,
+  24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42,
+  43, 44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61,
+  62, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77, 78, 79, 80,
+  81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91, 92, 93, 94, 95, 96, 97, 98, 99,
+  100, 101, 102, 103, 104, 105, 106, 107, 108, 109, 110, 111, 112, 113, 114,
+  115, 116, 117, 118, 119, 120, 121, 122, 123, 124, 125, 126, 127, 128, 129,
+  130, 131, 132, 133, 134, 135, 136, 137, 138, 139, 140, 141, 142, 143, 144,
+  145, 146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159,
+  160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174,
+  175, 176, 177, 178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189,
+  190, 191, 192, 193, 194, 195, 196, 197, 198, 199, 200, 201, 202, 203, 204,
+  205, 206, 207, 208, 209, 210, 211, 212, 213, 214, 215, 216, 217, 218, 219,
+  220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233, 234,
+  235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 246, 247, 248, 249,
+  250, 251, 252, 253, 254, 255, 256, 512, 521, 607, 1024, 1279, 2048, 2203,
+  2281, 3217, 4096, 4253, 4423,
+};
+
+/// the taps for nbits[i] are data[first[i]] to data[first[i+1]], excluding
+/// the leading tap which always is nbits[i]
+inline constexpr std::uint16_t first[] = {
+  0, 1, 2, 3, 4, 5, 8, 9, 10, 11, 14, 17, 20, 21, 24, 25, 26, 29, 30, 31, 32,
+  33, 36, 37, 40, 43, 44, 45, 48, 49, 52, 53, 56, 57, 58, 61, 64, 65, 68, 69,
+  72, 75, 78, 81, 84, 85, 88, 89, 92, 95, 96, 99, 102, 103, 106, 107, 108, 111,
+  112, 115, 118, 119, 122, 123, 126, 129, 130, 133, 136, 137, 140, 141, 144,
+  147, 150, 153, 156, 157, 160, 161, 164, 167, 168, 171, 174, 175, 178, 179,
+  182, 185, 188, 189, 190, 191, 194, 195, 196, 199, 200, 203, 206, 207, 210,
+  211, 212, 215, 216, 219, 222, 223, 226, 227, 230, 233, 236, 239, 240, 241,
+  244, 245, 248, 249, 250, 253, 256, 257, 260, 261, 262, 265, 266, 269, 270,
+  271, 274, 275, 278, 281, 282, 285, 286, 289, 292, 293, 296, 299, 300, 303,
+  304, 305, 308, 309, 312, 315, 318, 321, 324, 325, 328, 329, 332, 335, 338,
+  341, 344, 345, 348, 349, 350, 353, 354, 357, 358, 359, 362, 363, 364, 367,
+  370, 373, 376, 377, 380, 381, 384, 387, 390, 393, 396, 397, 400, 401, 402,
+  405, 408, 411, 412, 413, 416, 417, 418, 421, 424, 427, 430, 431, 434, 435,
+  438, 441, 442, 445, 448, 449, 452, 453, 454, 457, 460, 463, 466, 467, 470,
+  471, 474, 477, 480, 483, 486, 487, 490, 491, 492, 495, 496, 499, 502, 503,
+  506, 507, 510, 513, 516, 519, 522, 523, 526, 527, 528, 531, 532, 535, 538,
+  539, 542, 545, 546, 547, 550, 551, 554, 557, 558, 559, 562, 565, 566,
+};
+
+inline constexpr std::uint16_t data[] = {
+  2, 3, 3, 5, 6, 6, 5, 4, 5, 7, 9, 6, 4, 1, 4, 3, 1, 5, 3, 1, 14, 14, 13, 11,
+  14, 11, 6, 2, 1, 17, 19, 21, 18, 23, 22, 17, 22, 6, 2, 1, 5, 2, 1, 25, 27, 6,
+  4, 1, 28, 22, 2, 1, 20, 27, 2, 1, 33, 25, 36, 33, 31, 6, 5, 1, 35, 38, 21,
+  19, 38, 41, 20, 19, 42, 38, 37, 43, 18, 17, 44, 42, 41, 45, 26, 25, 42, 47,
+  21, 20, 40, 49, 24, 23, 50, 36, 35, 49, 52, 38, 37, 53, 18, 17, 31, 55, 35,
+  34, 50, 39, 58, 38, 37, 59, 60, 46, 45, 61, 6, 5, 62, 63, 61, 60, 47, 65, 57,
+  56, 66, 58, 57, 59, 67, 42, 40, 69, 55, 54, 65, 66, 25, 19, 48, 73, 59, 58,
+  74, 65, 64, 75, 41, 40, 76, 47, 46, 77, 59, 58, 70, 79, 43, 42, 77, 79, 47,
+  44, 82, 38, 37, 71, 84, 58, 57, 85, 74, 73, 74, 87, 17, 16, 51, 89, 72, 71,
+  90, 8, 7, 91, 80, 79, 91, 73, 84, 94, 49, 47, 91, 87, 97, 54, 52, 63, 100,
+  95, 94, 99, 97, 96, 94, 103, 94, 93, 89, 91, 105, 44, 42, 77, 108, 103, 102,
+  109, 98, 97, 101, 110, 69, 67, 104, 113, 33, 32, 114, 101, 100, 115, 46, 45,
+  115, 99, 97, 85, 111, 113, 9, 2, 103, 121, 63, 62, 121, 87, 124, 18, 17, 125,
+  90, 89, 126, 126, 101, 99, 124, 127, 130, 84, 83, 103, 132, 82, 81, 77, 124,
+  135, 11, 10, 116, 137, 131, 130, 136, 134, 131, 111, 140, 110, 109, 121, 142,
+  123, 122, 143, 75, 74, 93, 145, 87, 86, 146, 110, 109, 121, 148, 40, 39, 97,
+  148, 151, 87, 86, 152, 152, 27, 25, 154, 124, 123, 155, 41, 40, 156, 131,
+  130, 157, 132, 131, 128, 159, 142, 141, 143, 161, 75, 74, 162, 104, 103, 163,
+  151, 150, 164, 135, 134, 165, 128, 127, 161, 166, 153, 151, 135, 147, 169,
+  166, 165, 165, 171, 168, 165, 161, 169, 167, 165, 164, 169, 91, 178, 177,
+  175, 173, 170, 168, 180, 175, 174, 181, 176, 174, 127, 177, 176, 175, 161,
+  180, 178, 177, 182, 181, 180, 186, 183, 182, 187, 184, 183, 188, 184, 177,
+  182, 187, 181, 177, 178, 107, 193, 192, 187, 194, 187, 185, 195, 193, 188,
+  133, 165, 198, 197, 195, 187, 147, 202, 196, 195, 201, 200, 194, 203, 200,
+  196, 201, 197, 196, 164, 207, 205, 199, 203, 207, 206, 198, 203, 201, 200,
+  107, 211, 208, 207, 213, 211, 209, 192, 215, 213, 209, 172, 207, 218, 215,
+  211, 211, 210, 208, 219, 215, 213, 220, 217, 214, 190, 222, 217, 212, 193,
+  223, 219, 216, 223, 218, 217, 226, 217, 216, 228, 225, 219, 224, 223, 222,
+  205, 228, 223, 221, 159, 203, 234, 229, 226, 231, 236, 233, 230, 237, 236,
+  233, 203, 237, 235, 232, 171, 241, 236, 231, 242, 238, 235, 243, 240, 235,
+  244, 241, 239, 245, 244, 235, 165, 238, 234, 233, 163, 147, 249, 247, 244,
+  185, 251, 250, 246, 253, 252, 247, 203, 254, 251, 246, 510, 507, 504, 489,
+  502, 1015, 1002, 1001, 1063, 2035, 2034, 2029, 2198, 2197, 2189, 1566, 3150,
+  4095, 4081, 4069, 4242, 4241, 4232, 4152,
+};
+} // namespace detail::taps_table
@@ -1,13 +1,22 @@
 #include <algorithm>
+#include <array>
+#include <charconv>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <limits>
 #include <sstream>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "bignum_arithmetic.h"
 #include "integerselect.h"
 #include "lfsr.h"
 #include "lfsr_coefficients.h"
+#include "lfsr_taps_table.h"
 
 // list of taps
 // https://datacipy.cz/lfsr_table.pdf
@@ -135,44 +144,377 @@ private:
   State m_state = 1;
 };
 
-template<typename LFSR>
+enum class Format
+{
+  text,
+  hex,
+  binary,
+  bits
+};
+
+/// collects the output in a large buffer, instead of one write per state
+class OutputBuffer
+{
+public:
+  OutputBuffer() = default;
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+  ~OutputBuffer() { flush(); }
+
+  void put(const char c)
+  {
+    if (m_used == m_buffer.size()) {
+      flush();
+    }
+    m_buffer[m_used++] = c;
+  }
+
+  void write(const char* data, std::size_t n)
+  {
+    while (n > 0) {
+      if (m_used == m_buffer.size()) {
+        flush();
+      }
+      const auto chunk = std::min(n, m_buffer.size() - m_used);
+      std::copy(data, data + chunk, m_buffer.data() + m_used);
+      m_used += chunk;
+      data += chunk;
+      n -= chunk;
+    }
+  }
+
+  void flush()
+  {
+    std::fwrite(m_buffer.data(), 1, m_used, stdout);
+    m_used = 0;
+  }
+
+private:
+  std::vector<char> m_buffer = std::vector<char>(1 << 20);
+  std::size_t m_used = 0;
+};
+
+/// packs bits lsb first into bytes
+class BitPacker
+{
+public:
+  explicit BitPacker(OutputBuffer& out)
+    : m_out(out)
+  {
+  }
+  ~BitPacker()
+  {
+    if (m_fill > 0) {
+      m_out.put(static_cast<char>(m_acc));
+    }
+  }
+
+  /// appends the nbits (at most 8) lowest bits of value
+  void append(const unsigned value, const unsigned nbits)
+  {
+    m_acc |= (value & ((1U << nbits) - 1U)) << m_fill;
+    m_fill += nbits;
+    if (m_fill >= 8) {
+      m_out.put(static_cast<char>(m_acc));
+      m_acc >>= 8;
+      m_fill -= 8;
+    }
+  }
+
+private:
+  OutputBuffer& m_out;
+  unsigned m_acc = 0;
+  unsigned m_fill = 0;
+};
+
+/// the state as N bits, little endian
+template<std::size_t N, typename State>
+std::array<unsigned char, (N + 7) / 8>
+to_bytes(const State& state)
+{
+  std::array<unsigned char, (N + 7) / 8> ret;
+  for (std::size_t i = 0; i < ret.size(); ++i) {
+    if constexpr (std::is_integral_v<State>) {
+      ret[i] = static_cast<unsigned char>(state >> (8 * i));
+    } else {
+      // limbs are a multiple of 8 bits wide, so bytes never straddle them
+      constexpr std::size_t BitsPerLimb = State::BitsPerLimb;
+      ret[i] = static_cast<unsigned char>(state.m_data[8 * i / BitsPerLimb] >>
+                                          (8 * i % BitsPerLimb));
+    }
+  }
+  return ret;
+}
+
+void
+write_decimal(OutputBuffer& out, const std::uint64_t value)
+{
+  char digits[20];
+  const auto result =
+    std::to_chars(std::begin(digits), std::end(digits), value);
+  out.write(digits, static_cast<std::size_t>(result.ptr - digits));
+}
+
+template<std::size_t N, typename State>
+void
+write_decimal(OutputBuffer& out, const State& state)
+{
+  if constexpr (std::is_integral_v<State>) {
+    write_decimal(out, std::uint64_t{ state });
+  } else {
+    // 19 decimal digits at a time, least significant first
+    constexpr std::uint64_t TenToThe19 = 10'000'000'000'000'000'000ULL;
+    const auto bytes = to_bytes<N>(state);
+    BigNum<N, std::uint64_t> value;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+      value.m_data[i / 8] |= std::uint64_t{ bytes[i] } << (8 * (i % 8));
+    }
+    std::vector<std::uint64_t> chunks;
+    do {
+      chunks.push_back(divide_in_place(value, TenToThe19));
+    } while (value != BigNum<N, std::uint64_t>{});
+    write_decimal(out, chunks.back());
+    for (std::size_t i = chunks.size() - 1; i > 0; --i) {
+      auto chunk = chunks[i - 1];
+      char digits[19];
+      for (std::size_t j = std::size(digits); j > 0; --j) {
+        digits[j - 1] = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+      }
+      out.write(digits, std::size(digits));
+    }
+  }
+}
+
+template<typename State>
+unsigned
+lowest_bit(const State& state)
+{
+  if constexpr (std::is_integral_v<State>) {
+    return state & 1U;
+  } else {
+    return state.ith_bit(0);
+  }
+}
+
+template<std::size_t N, typename State>
+void
+write_hex(OutputBuffer& out, const State& state)
+{
+  constexpr std::size_t ndigits = (N + 3) / 4;
+  const auto bytes = to_bytes<N>(state);
+  char digits[ndigits];
+  for (std::size_t i = 0; i < ndigits; ++i) {
+    const unsigned nibble = (bytes[i / 2] >> (4 * (i % 2))) & 0xFU;
+    digits[ndigits - 1 - i] = "0123456789abcdef"[nibble];
+  }
+  out.write(digits, ndigits);
+}
+
+template<std::size_t N, typename LFSR>
+void
+write_keystream(OutputBuffer& out, LFSR& x, std::uint64_t count)
+{
+  BitPacker packer(out);
+  // the state holds the next N output bits, so a register which can step
+  // many times at once can produce them N at a time
+  if constexpr (requires { x.next(std::size_t{}); }) {
+    for (; count >= N; count -= N) {
+      const auto bytes = to_bytes<N>(x.state());
+      for (std::size_t i = 0; i < N / 8; ++i) {
+        packer.append(bytes[i], 8);
+      }
+      if constexpr (N % 8 != 0) {
+        packer.append(bytes.back(), N % 8);
+      }
+      x.next(N);
+    }
+  }
+  // one byte at a time, then the remaining bits
+  for (; count > 0;) {
+    const auto nbits = static_cast<unsigned>(std::min<std::uint64_t>(count, 8));
+    unsigned byte = 0;
+    for (unsigned i = 0; i < nbits; ++i) {
+      byte |= lowest_bit(x.state()) << i;
+      x.next();
+    }
+    packer.append(byte, nbits);
+    count -= nbits;
+  }
+}
+
+/**
+ * writes count states, or count bits of the output sequence for
+ * Format::bits. the state before stepping is written first.
+ */
+template<std::size_t N, typename LFSR>
 int
-run_impl()
+run_impl(const Format format, const std::uint64_t count)
 {
   LFSR x;
-  const auto initial = x.state();
-  do {
-    std::cout << x.state() << '\n';
+  OutputBuffer out;
+  if (format == Format::bits) {
+    write_keystream<N>(out, x, count);
+    return 0;
+  }
+  for (std::uint64_t i = 0; i < count; ++i) {
+    switch (format) {
+      case Format::text:
+        write_decimal<N>(out, x.state());
+        out.put('\n');
+        break;
+      case Format::hex:
+        write_hex<N>(out, x.state());
+        out.put('\n');
+        break;
+      case Format::binary: {
+        const auto bytes = to_bytes<N>(x.state());
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        break;
+      }
+      case Format::bits:
+        break;
+    }
     x.next();
-  } while (x.state() != initial);
+  }
   return 0;
 }
 
+/// the number of states in one period, or as many as possible
+template<std::size_t N>
+constexpr std::uint64_t
+full_period()
+{
+  if constexpr (N >= 64) {
+    return std::numeric_limits<std::uint64_t>::max();
+  } else {
+    return (std::uint64_t{ 1 } << N) - 1;
+  }
+}
+
+using Runner = int (*)(Format, std::uint64_t count);
+
+struct DispatchEntry
+{
+  std::size_t nbits;
+  std::uint64_t period;
+  Runner run;
+};
+
+/// uses the native integer implementation when the state fits in one
+template<std::size_t N>
+constexpr DispatchEntry
+make_entry()
+{
+  if constexpr (N <= 64) {
+    return { N, full_period<N>(), &run_impl<N, SmallLFSR<N>> };
+  } else {
+    return { N, full_period<N>(), &run_impl<N, BigLFSR<N>> };
+  }
+}
+
+template<std::size_t... I>
+constexpr auto
+make_dispatch_table(std::index_sequence<I...>)
+{
+  return std::array<DispatchEntry, sizeof...(I)>{
+    make_entry<detail::taps_table::nbits[I]>()...
+  };
+}
+
+/// one entry for every register length with known taps, sorted on nbits
+constexpr auto dispatch_table = make_dispatch_table(
+  std::make_index_sequence<std::size(detail::taps_table::nbits)>{});
+
+template<typename T>
+T
+parse(const char* arg)
+{
+  std::stringstream x(arg);
+  T value;
+  if (!(x >> value) || !x.eof()) {
+    std::cerr << "failed parse of " << arg << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  return value;
+}
+
+void
+usage(const char* argv0)
+{
+  std::cerr
+    << "usage: " << argv0 << " [-n N] [-f format] [-c count] [impl]\n"
+    << "  impl       one of the 16 bit implementations 0-3, default 0\n"
+    << "  -n N       register length, overrides impl\n"
+    << "  -f format  text (default), hex, binary (little endian states)\n"
+    << "             or bits (the output sequence, packed lsb first)\n"
+    << "  -c count   the number of states or bits, default one period\n";
+  std::exit(EXIT_FAILURE);
+}
+
 int
 main(int argc, char* argv[])
 {
-
   int impl = 0;
-  if (argc > 1) {
-    std::stringstream x(argv[1]);
-    if (!(x >> impl)) {
-      std::cout << "failed parse\n";
-      std::abort();
+  std::size_t nbits = 0;
+  Format format = Format::text;
+  std::uint64_t count = 0;
+  bool have_count = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-n" && i + 1 < argc) {
+      nbits = parse<std::size_t>(argv[++i]);
+    } else if (arg == "-c" && i + 1 < argc) {
+      count = parse<std::uint64_t>(argv[++i]);
+      have_count = true;
+    } else if (arg == "-f" && i + 1 < argc) {
+      const std::string f = argv[++i];
+      if (f == "text") {
+        format = Format::text;
+      } else if (f == "hex") {
+        format = Format::hex;
+      } else if (f == "binary") {
+        format = Format::binary;
+      } else if (f == "bits") {
+        format = Format::bits;
+      } else {
+        usage(argv[0]);
+      }
+    } else if (arg.starts_with("-")) {
+      usage(argv[0]);
+    } else {
+      impl = parse<int>(argv[i]);
+    }
+  }
+
+  if (nbits != 0) {
+    const auto it = std::lower_bound(
+      dispatch_table.begin(),
+      dispatch_table.end(),
+      nbits,
+      [](const DispatchEntry& e, std::size_t n) { return e.nbits < n; });
+    if (it == dispatch_table.end() || it->nbits != nbits) {
+      std::cerr << "no taps known for N=" << nbits << '\n';
+      return EXIT_FAILURE;
     }
+    return it->run(format, have_count ? count : it->period);
   }
 
+  if (!have_count) {
+    count = full_period<16>();
+  }
   switch (impl) {
     case 0:
-      return run_impl<LFSR_wikipedia>();
+      return run_impl<16, LFSR_wikipedia>(format, count);
     case 1:
-      return run_impl<LFSR16_v2>();
+      return run_impl<16, LFSR16_v2>(format, count);
     case 2: {
       using LFSR = LFSR16_v3<16>;
-      return run_impl<LFSR>();
+      return run_impl<16, LFSR>(format, count);
     }
     case 3: {
       using LFSR = BigLFSR<16>;
-      //  return run_impl<LFSR>();
+      return run_impl<16, LFSR>(format, count);
     }
     default:
       std::cout << "unknown implementation\n";
@@ -0,0 +1,219 @@
+// searches for maximal length LFSR taps, that is primitive polynomials over
+// GF(2) with as few terms as possible. the output has the same format as
+// lfsr_taps.txt, so it can be appended to it before running
+// generate_taps_table.py.
+//
+// usage: lfsrsearch [-j threads] first [last]
+//
+// trinomials x^n+x^k+1 are tried first, then pentanomials x^n+x^a+x^b+x^c+1.
+// the candidates are enumerated with the low exponents as small as possible,
+// and the reciprocal is printed (which is primitive as well) so the taps end
+// up close to N. the candidates are tested in parallel, but the result is the
+// same as a sequential search would give.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gf2poly.h"
+#include "mersenne_factors.h"
+#include "primitivity.h"
+
+namespace {
+
+/// the exponents below n of a candidate, in descending order
+using Exponents = std::vector<int>;
+
+std::uint64_t
+trinomial_count(const int n)
+{
+  return static_cast<std::uint64_t>(n / 2);
+}
+
+std::uint64_t
+pentanomial_count(const int n)
+{
+  // a > b > c > 0 with a < n
+  if (n < 4) {
+    return 0;
+  }
+  const auto m = static_cast<std::uint64_t>(n - 1);
+  return m * (m - 1) * (m - 2) / 6;
+}
+
+/**
+ * the candidate with the given index. the trinomials come first, with k<=n/2
+ * since the reciprocal of x^n+x^k+1 is x^n+x^(n-k)+1. the pentanomials are
+ * ordered on a, then b, then c.
+ */
+Exponents
+candidate(const int n, std::uint64_t index)
+{
+  if (index < trinomial_count(n)) {
+    return { static_cast<int>(index) + 1, 0 };
+  }
+  index -= trinomial_count(n);
+  std::uint64_t a = 3;
+  // there are (a-1)(a-2)/2 pairs b,c for each a
+  while (index >= (a - 1) * (a - 2) / 2) {
+    index -= (a - 1) * (a - 2) / 2;
+    ++a;
+  }
+  std::uint64_t b = 2;
+  while (index >= b - 1) {
+    index -= b - 1;
+    ++b;
+  }
+  return { static_cast<int>(a),
+           static_cast<int>(b),
+           static_cast<int>(index + 1),
+           0 };
+}
+
+template<int N>
+bool
+test_candidate(const int n,
+               const Exponents& exponents,
+               std::span<const BigNum<N, std::uint64_t>> factors)
+{
+  typename Gf2Modulus<N>::Element low;
+  for (const auto e : exponents) {
+    low.set_bit_to(e, true);
+  }
+  return is_primitive(Gf2Modulus<N>(low, n), factors);
+}
+
+/// finds the first primitive candidate, testing candidates in parallel
+template<int N>
+std::optional<Exponents>
+search(const int n, const int nthreads)
+{
+  const auto hexfactors = mersenne_factors(n);
+  if (!hexfactors) {
+    std::cerr << "the factorization of 2^" << n
+              << "-1 is not known, add it to mersenne_factors.h\n";
+    return std::nullopt;
+  }
+  const auto factors = parse_factors<N>(*hexfactors);
+  const std::uint64_t total = trinomial_count(n) + pentanomial_count(n);
+
+  std::atomic<std::uint64_t> next{ 0 };
+  std::atomic<std::uint64_t> best{ total };
+  auto worker = [&]() {
+    for (;;) {
+      const auto index = next.fetch_add(1);
+      // every candidate before best is tested by some thread, so stopping
+      // here keeps the result deterministic
+      if (index >= best.load()) {
+        return;
+      }
+      if (test_candidate<N>(
+            n,
+            candidate(n, index),
+            std::span<const BigNum<N, std::uint64_t>>(factors))) {
+        auto current = best.load();
+        while (index < current && !best.compare_exchange_weak(current, index)) {
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int i = 1; i < nthreads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (best.load() == total) {
+    return std::nullopt;
+  }
+  return candidate(n, best.load());
+}
+
+/// dispatches the runtime degree to the smallest capacity that fits
+std::optional<Exponents>
+search_any(const int n, const int nthreads)
+{
+  if (n <= 64) {
+    return search<64>(n, nthreads);
+  } else if (n <= 128) {
+    return search<128>(n, nthreads);
+  } else if (n <= 256) {
+    return search<256>(n, nthreads);
+  } else if (n <= 512) {
+    return search<512>(n, nthreads);
+  } else if (n <= 1024) {
+    return search<1024>(n, nthreads);
+  } else if (n <= 2048) {
+    return search<2048>(n, nthreads);
+  } else if (n <= 4096) {
+    return search<4096>(n, nthreads);
+  } else if (n <= 8192) {
+    return search<8192>(n, nthreads);
+  }
+  std::cerr << "degree " << n << " is too large\n";
+  return std::nullopt;
+}
+
+int
+parse_int(const char* arg)
+{
+  std::stringstream x(arg);
+  int value;
+  if (!(x >> value) || !x.eof()) {
+    std::cerr << "failed parse of " << arg << '\n';
+    std::exit(EXIT_FAILURE);
+  }
+  return value;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  int nthreads =
+    std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  std::vector<int> args;
+  for (int i = 1; i < argc; ++i) {
+    if (std::string(argv[i]) == "-j" && i + 1 < argc) {
+      nthreads = std::max(1, parse_int(argv[++i]));
+    } else {
+      args.push_back(parse_int(argv[i]));
+    }
+  }
+  if (args.empty() || args.size() > 2 || args.front() < 2) {
+    std::cerr << "usage: " << argv[0] << " [-j threads] first [last]\n";
+    return EXIT_FAILURE;
+  }
+  const int first = args.front();
+  const int last = args.back();
+
+  int ret = EXIT_SUCCESS;
+  for (int n = first; n <= last; ++n) {
+    const auto exponents = search_any(n, nthreads);
+    if (!exponents) {
+      std::cerr << "no taps found for N=" << n << '\n';
+      ret = EXIT_FAILURE;
+      continue;
+    }
+    // print the reciprocal polynomial, which has the taps close to n
+    std::cout << n;
+    for (auto it = exponents->rbegin(); it != exponents->rend(); ++it) {
+      if (*it != 0) {
+        std::cout << ' ' << n - *it;
+      }
+    }
+    std::cout << std::endl;
+  }
+  return ret;
+}
@@ -0,0 +1,442 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include "bignum.h"
+
+/*
+ * the prime factorization of 2^n-1, which is needed to test whether a
+ * polynomial of degree n is primitive.
+ *
+ * the factors are from the cunningham project tables, in hex and with
+ * multiplicity. each entry has been checked to multiply to 2^n-1 with every
+ * factor being a probable prime. exponents for which 2^n-1 is prime are
+ * listed separately.
+ */
+
+namespace detail::mersenne {
+struct Factorization
+{
+  int n;
+  std::string_view factors;
+};
+
+/// sorted on n
+inline constexpr Factorization factorizations[] = {
+  { 4, "3 5" },
+  { 6, "3 3 7" },
+  { 8, "3 5 11" },
+  { 9, "7 49" },
+  { 10, "3 b 1f" },
+  { 11, "17 59" },
+  { 12, "3 3 5 7 d" },
+  { 14, "3 2b 7f" },
+  { 15, "7 1f 97" },
+  { 16, "3 5 11 101" },
+  { 18, "3 3 3 7 13 49" },
+  { 20, "3 5 5 b 1f 29" },
+  { 21, "7 7 7f 151" },
+  { 22, "3 17 59 2ab" },
+  { 23, "2f 2b931" },
+  { 24, "3 3 5 7 d 11 f1" },
+  { 25, "1f 259 709" },
+  { 26, "3 aab 1fff" },
+  { 27, "7 49 40201" },
+  { 28, "3 5 1d 2b 71 7f" },
+  { 29, "e9 44f 829" },
+  { 30, "3 3 7 b 1f 97 14b" },
+  { 32, "3 5 11 101 10001" },
+  { 33, "7 17 59 925b7" },
+  { 34, "3 aaab 1ffff" },
+  { 35, "1f 47 7f 1e029" },
+  { 36, "3 3 3 5 7 d 13 25 49 6d" },
+  { 37, "df 24bc44e1" },
+  { 38, "3 2aaab 7ffff" },
+  { 39, "7 4f 1fff 1da19" },
+  { 40, "3 5 5 b 11 1f 29 f0f1" },
+  { 41, "3437 9ce3e79" },
+  { 42, "3 3 7 7 2b 7f 151 152b" },
+  { 43, "1af 25f7 200a97" },
+  { 44, "3 5 17 59 18d 2ab 841" },
+  { 45, "7 1f 49 97 277 5b0f" },
+  { 46, "3 2f 2b931 2aaaab" },
+  { 47, "92f 11a1 ca6691" },
+  { 48, "3 3 5 7 d 11 61 f1 101 2a1" },
+  { 49, "7f 40810204081" },
+  { 50, "3 b 1f fb 259 709 fd3" },
+  { 51, "7 67 85f 2b6f 1ffff" },
+  { 52, "3 5 35 9d 64d aab 1fff" },
+  { 53, "18d9 10f37 13731a1" },
+  { 54, "3 3 3 3 7 13 49 154ab 40201" },
+  { 55, "17 1f 59 371 c77 314e9" },
+  { 56, "3 5 11 1d 2b 71 7f f0f0f1" },
+  { 57, "7 7e79 7ffff 1281af" },
+  { 58, "3 3b e9 44f 829 2e4851" },
+  { 59, "2beef 2e9db69cff1" },
+  { 60, "3 3 5 5 7 b d 1f 29 3d 97 14b 529" },
+  { 62, "3 2aaaaaab 7fffffff" },
+  { 63, "7 7 49 7f 151 16a41 9e9b9" },
+  { 64, "3 5 11 101 281 10001 663d81" },
+  { 65, "1f 1fff 8425296b5bdf" },
+  { 66, "3 3 7 17 43 59 2ab 5179 925b7" },
+  { 67, "b8bbec9 b161194487" },
+  { 68, "3 5 89 3b9 66cd aaab 1ffff" },
+  { 69, "7 2f 2b931 924925b6db7" },
+  { 70, "3 b 1f 2b 47 7f 119 1509b 1e029" },
+  { 71, "37c7f 2e4b979 cb06149" },
+  { 72, "3 3 3 5 7 d 11 13 25 49 6d f1 1b1 9751" },
+  { 73, "1b7 2310b9 883c1153d41" },
+  { 74, "3 df 6f1 189635b 24bc44e1" },
+  { 75, "7 1f 97 259 709 189c1 a13e21" },
+  { 76, "3 5 e5 1c9 2aaab 7ffff 80401" },
+  { 77, "17 59 7f 8112264cd9bb77f" },
+  { 78, "3 3 7 4f aab 1fff 1da19 1554aab" },
+  { 79, "a7f c0aba87 103413e6cb7" },
+  { 80, "3 5 5 b 11 1f 29 101 f0f1 ff00ff01" },
+  { 81, "7 49 a21 115cf 40201 5d2914f" },
+  { 82, "3 53 3437 9ce3e79 20e64c149" },
+  { 83, "a7 c4372f855d824ca58e9" },
+  { 84, "3 3 5 7 7 d 1d 2b 71 7f 151 595 152b 3871" },
+  { 85, "1f 1ffff 84214a52b5ad7bdf" },
+  { 86, "3 1af 25f7 200a97 2aaaaaaaaab" },
+  { 87, "7 e9 44f 829 1051 8f72eebe387" },
+  { 88, "3 5 11 17 59 161 18d 2ab 841 aebbc991" },
+  { 90, "3 3 3 7 b 13 1f 49 97 14b 277 5b0f 11f6e09" },
+  { 91, "7f 38f 1fff 6babc21 5634792f1" },
+  { 92, "3 5 2f 115 3f5 679 763d 2b931 2aaaab" },
+  { 93, "7 7fffffff 924924936db6db7" },
+  { 94, "3 11b 92f 11a1 ca6691 26989325b1" },
+  { 95, "1f bf 7ffff 191492ff 70fa3a01f" },
+  { 96, "3 3 5 7 d 11 61 c1 f1 101 2a1 10001 1538f41" },
+  { 97, "2cb7 b73493decfd9b68318ef9" },
+  { 98, "3 2b 7f 3f80fe03f81 40810204081" },
+  { 99, "7 17 49 59 c7 25831 925b7 7b2661a6f" },
+  { 100, "3 5 5 5 b 1f 29 65 fb 259 709 fd3 1fa5 418d5" },
+  { 101, "6c279f03a0f 4bbe4964e1a8b11" },
+  { 102, "3 3 7 67 133 85f b29 1981 2b6f aaab 1ffff" },
+  { 103, "9800b777 d79331b1cd9080adb9" },
+  { 104, "3 5 11 35 9d 64d aab 1fff d1791 12675361" },
+  { 105, "7 7 1f 47 7f 97 151 7207 1a0b9 1e029 251e9" },
+  { 106, "3 6b 18d9 10f37 13731a1 19852f0d8ec1" },
+  { 108, "3 3 3 3 5 7 d 13 25 49 6d 154ab 3c1e1 40201 44221" },
+  { 109, "2c76e2c7 b83cbeccdc926056c109" },
+  { 110, "3 b b 17 1f 59 2ab 371 b9b c77 314e9 2ea586b" },
+  { 111, "7 df 4e88f 1913ca1 1303dcb9 24bc44e1" },
+  { 112, "3 5 11 1d 2b 71 7f 101 1421 f0f0f1 cab258ee1" },
+  { 113, "d3f 5aef 101c9 1c8319 3ca43f3d97c6f" },
+  { 114, "3 3 7 23b 7e79 2aaab 7ffff 1281af 9908251" },
+  { 115, "1f 2f 3a67 2b931 3d9961 966fc18022f69" },
+  { 116, "3 5 3b e9 44f 829 2e4851 6664ccd 20008001" },
+  { 117, "7 49 4f 3a9 1999 1fff 15061 1da19 1d2b61f99" },
+  { 118, "3 b11 9133 2beef 6cc31c19 2e9db69cff1" },
+  { 119, "7f ef 4f07 1ffff eaa150caf 1e867bff69" },
+  { 120, "3 3 5 5 7 b d 11 1f 29 3d 97 f1 14b 529 f0f1 10feef011" },
+  { 121, "17 59 2d7 168c2661efceb3c3748ef748e7" },
+  { 122, "3 aaaaaaaaaaaaaab 1fffffffffffffff" },
+  { 123, "7 3437 3b4fc7 9ce3e79 2776572c79ed291" },
+  { 124, "3 5 15cd 21e9 c145 5df05 2aaaaaab 7fffffff" },
+  { 125, "1f 259 709 3ea70096b1 41606b48636df251" },
+  { 126, "3 3 3 7 7 13 2b 49 7f 151 152b 16a41 9e9b9 11f703ee09" },
+  { 128, "3 5 11 101 281 10001 42f01 663d81 3d30f19cd101" },
+  { 129, "7 1af 25f7 200a97 924924924936db6db6db7" },
+  { 130, "3 b 1f 83 aab 1fff 64123 7454ab 8425296b5bdf" },
+  { 131, "107 7c97d9108c2ad4329db02eb8f166349" },
+  { 132, "3 3 5 7 d 17 43 59 18d 2ab 841 5179 4c585 925b7 420841" },
+  { 133, "7f 7ffff 8102142852a54ad5ab5ebd7bf7f" },
+  { 134, "3 6fcfa9 b8bbec9 b161194487 61b04216c33" },
+  { 135, "7 1f 49 97 10f 277 5b0f 40201 54f7f 2d72ec879791" },
+  { 136, "3 5 11 11 89 3b9 66cd aaab 1ffff 56981 29e66824961" },
+  { 137, "1bc894a5efde5b971 126d9df90b42f22186f" },
+  { 138, "3 3 7 2f 8b 2b931 2aaaab 274a482261 924925b6db7" },
+  { 139, "51dd9dbc32f 19043ef56cca6ea8fda319c31" },
+  { 140, "3 5 5 b 1d 1f 29 2b 47 71 7f 119 1509b 1e029 712a29 2d3267d" },
+  { 141, "7 92f 11a1 ca6691 104ce069f 8f97384b16239e9" },
+  { 142, "3 37c7f 2e4b979 35cbe2b cb06149 cb097a80581" },
+  { 143, "17 59 1fff b0cb9 24fa95ea07 503e66e6e16f8c11" },
+  { 144, "3 3 3 5 7 d 11 13 25 49 61 6d f1 101 1b1 241 2a1 9751 7194a10dc1" },
+  { 145, "1f e9 44f 829 84210846318c6339ce739def7bdf" },
+  { 146, "3 1b7 6d9 2310b9 883c1153d41 18ec61f0e8e0b323" },
+  { 147, "7 7 7 7f 151 40810204081 244925b49252490049237" },
+  { 148, "3 5 95 df 251 6f1 189635b afef559 dd086b1 24bc44e1" },
+  { 149, "4b298e922ee1921ef 6cfda2bf2e119388fd2f1" },
+  { 150, "3 3 7 b 1f 97 fb 14b 259 709 fd3 189c1 a13e21 107fdef8021" },
+  { 151, "46c9 da3f 287a7 239917 6078645e5a63722b9e4b9" },
+  { 152, "3 5 11 e5 1c9 4c1 245e1 2aaab 7ffff 80401 164c4ff76c51" },
+  { 153, "7 49 67 397 85f 2b6f 1ffff 3e8536e8565ccbc95728ef" },
+  { 154, "3 17 2b 59 7f 269 2ab 13199 845e4d943 8112264cd9bb77f" },
+  { 155, "1f 1f 137 2ccf 11eff 7fffffff 1152823a9 1083c9a54a9f" },
+  { 156, "3 3 5 7 d d 35 4f 9d 139 4e1 64d aab c31 1fff 5551 1da19 1554aab" },
+  { 157, "32ca8551 e23940087 1811d8a6209 79536c8eb4a71" },
+  { 158, "3 a7f c0aba87 103413e6cb7 2aaaaaaaaaaaaaaaaaab" },
+  { 159, "7 18d9 1a17 10f37 d50409 13731a1 203a7441 3586873a59" },
+  { 160, "3 5 5 b 11 1f 29 101 f0f1 10001 65401 ff00ff01 28741f88ac01" },
+  { 161, "2f 7f 509 2b931 30a81f a7ebddb09 cd82be41f9819351" },
+  { 162, "3 3 3 3 3 7 13 49 a3 a21 115cf 154ab 21109 40201 5d2914f 10368ed1" },
+  { 163, "24b0f abea1 691b191 671353d59 1f6cc6e796f81d5c9" },
+  { 164, "3 5 53 27b9 3437 2c52d b8d2a5 293efb5 9ce3e79 20e64c149" },
+  { 165, "7 17 1f 59 97 371 c77 314e9 925b7 1b1cd239b201b239a4727" },
+  { 166, "3 a7 1f3 48b a61 25ef1 322075ceb c4372f855d824ca58e9" },
+  { 167, "23d7df 39233f1831293e724d944f759295c219d5be1" },
+  { 168,
+    "3 3 5 7 7 d 11 1d 2b 71 7f f1 151 595 d21 152b 3871 f0f0f1 14b66c14f1" },
+  { 169, "fd9 1fff 6215b87c031 2a2a95cadcf0ee19df1a9a4db9" },
+  { 170, "3 b 1f aaab 1ffff 84214a52b5ad7bdf 1745c5d17a2e88ba3" },
+  { 171, "7 49 7e79 7ffff 1281af 592ceaf 2844e267e7858232cb3d7" },
+  { 172, "3 5 ad 1af 25f7 18d15 7a1d1 200a97 199998ccccd 2aaaaaaaaab" },
+  { 173, "b2681 16f8a7 f8fd6c8288fb07 20e20e984dd3d96be70f" },
+  { 174, "3 3 7 3b e9 44f 829 1051 2e4851 8f72eebe387 15555554aaaaaab" },
+  { 175, "1f 47 7f 259 709 9a7f 1e029 39ffa81 715d40bd829492cd201f" },
+  { 176, "3 5 11 17 59 101 161 18d 2ab 841 37f21 723bc21 aebbc991 a36fa2fc1" },
+  { 177, "7 2beef 2cf11 684549de1 2e9db69cff1 7fdd5e49fcc05327" },
+  { 178, "3 b3 3b25d21 4206c0e73e7409 1ffffffffffffffffffffff" },
+  { 179, "167 599 104e5a80a157457abc6482776a0e7ee78c616da91" },
+  { 180,
+    "3 3 3 5 5 7 b d 13 1f 25 29 3d 49 6d 97 b5 14b 277 529 5b0f d2f1 "
+    "11f6e09 1be48ad" },
+  { 181, "a9b1 11c3a1 74b451 5f6150206cbaeb0a51284f6f516249f" },
+  { 182, "3 2b 7f 38f aab 1fff 36e03 127873 6babc21 5634792f1 60391d13b" },
+  { 183, "7 16f d951 1fffffffffffffff 7834883996202c2aab7ee269" },
+  { 184, "3 5 11 2f 115 3f5 679 763d 2b931 2aaaab f0f0f0f0f0f0f0f0f0f0f1" },
+  { 185, "1f df 24bc44e1 5a42576d55c57 176c12ed905937f6a3b5a7b9" },
+  { 186, "3 3 7 1f8fb21b 2aaaaaab 7fffffff ad09f2b1 924924936db6db7" },
+  { 187, "17 59 1ffff acd8f bdabf2cddbdec98dd68a9906cc49096d691" },
+  { 188, "3 5 11b 92f eb1 11a1 ca6691 1be157edd 26989325b1 7fffff000001" },
+  { 189, "7 7 49 7f 151 16a41 40201 9e9b9 17cdc7 abbcb671934086d21ff5f7" },
+  { 190, "3 b 1f bf 8e9 2aaab 7ffff 191492ff 70fa3a01f 29ca7493f1acd8ab" },
+  { 191, "17f 1a551cea9 94c9e0d91 12e7bddf70521 4bb2d4cbc16cfe6e9" },
+  { 192,
+    "3 3 5 7 d 11 61 c1 f1 101 281 2a1 10001 663d81 1538f41 ffffffff00000001" },
+  { 193, "d2e63f d0e4b3d2cea3f40a56f 2f9a3e875747393d2f09274f" },
+  { 194, "3 3cb 611 2cb7 7c49 f4718e7f062a309 b73493decfd9b68318ef9" },
+  { 195, "7 1f 4f 97 1fff 1da19 8425296b5bdf 1b1f5d3ebab3b3b574fae9f27" },
+  { 196, "3 5 1d 2b 71 7f c5 496ab63bd 3f80fe03f81 40810204081 487eddbc091" },
+  { 197, "1d3f 1181b149e3e4c85e5f1fb2507d481cb8c6dd39e358bad41" },
+  { 198,
+    "3 3 3 7 13 17 43 49 59 c7 2ab 14e3 5179 25831 925b7 7b2661a6f "
+    "dc3048aa1123" },
+  { 199, "264d41dea1 357857e1c1fc34d6b12d8cd398b9b7ebd953e7a9f" },
+  { 200,
+    "3 5 5 5 b 11 1f 29 65 fb 191 259 709 fd3 1fa5 f0f1 418d5 53341 2a8911 "
+    "bd261521" },
+  { 201, "7 649 565f b8bbec9 b161194487 44fc4539d00b0dc3480f3a32661" },
+  { 202, "3 6c279f03a0f 4bbe4964e1a8b11 aaaaaaaaaaaaaaaaaaaaaaaab" },
+  { 203, "7f e9 44f 829 214e1 7426d77 8898e565e58d448bd195b49c5821e59" },
+  { 204,
+    "3 3 5 7 d 67 89 133 199 3b9 85f b29 bf5 1981 2b6f 3565 66cd aaab 1ffff "
+    "4f13d8c5" },
+  { 205, "1f 3437 2cde69 9ce3e79 105689b547 2e2448e625b7b116cd46fd7841" },
+  { 206, "3 9800b777 60a85e90f1 7100eb84c5bf755b d79331b1cd9080adb9" },
+  { 207, "7 2f 49 1381f 2b931 25d2c3cf 207d00e8eff 924925b6db7 2659a6356b97" },
+  { 208,
+    "3 5 11 35 9d 101 64d aab 1fff d1791 12675361 ff00ff00ff00ff00ff00ff01" },
+  { 209, "17 59 7ffff 563923f99889 55f792d2cd36f 46c42c50808084c661aa9" },
+  { 210,
+    "3 3 7 7 b 1f 2b 47 7f 97 d3 119 14b 151 152b 7207 1509b 1a0b9 1e029 "
+    "251e9 a2379 17e0f9" },
+  { 211, "3b59 344748e89698f3c89 a8fbb4898018b5f28b18299cf748c3a9f" },
+  { 212,
+    "3 5 6b 18d9 10f37 ea58b1 13731a1 22f4f051 19852f0d8ec1 6666664cccccd" },
+  { 213, "7 10399 37c7f 2e4b979 cb06149 278cd08de7b055c7 3a5c1d7cddcaa7b9" },
+  { 214, "3 283 10fcaea5e3998c02a77b49eb9 7ffffffffffffffffffffffffff" },
+  { 215, "1f 1af 6b9 25f7 200a97 2b9a0e0f 77df908557 f6708ebd39a380cdecd6ef" },
+  { 216,
+    "3 3 3 3 5 7 d 11 13 25 49 6d f1 1b1 9751 154ab 3c1e1 40201 44221 "
+    "2066e81 7e697b0bd181" },
+  { 217, "7f 1459 f421 7fffffff 153d3be36cf98b6547f 5022aaa5f4a4e9f903c9" },
+  { 218, "3 634d0e9 2c76e2c7 b83cbeccdc926056c109 1b7fb6ca4d87aa3770273" },
+  { 219, "7 1b7 f67 2310b9 883c1153d41 95075d42c725f29 10509ea19e5e9f126c9" },
+  { 220,
+    "3 5 5 b b 17 1f 29 59 18d 2ab 371 841 b9b c77 314e9 2ea586b 60d4495dd9 "
+    "34d3326680d" },
+  { 221, "52f 1fff 1ffff 18b24d93fde40bad95f2f56d9d8916eb26f35b891cbe31" },
+  { 222,
+    "3 3 7 df 6f1 d03 4483 4e88f 189635b 1913ca1 1303dcb9 24bc44e1 "
+    "62056060c093" },
+  { 223, "476f 3004f 166051 2c81e9 4fa957eb6e9eb9aaa1 7e426048db98f7ad2d57" },
+  { 224,
+    "3 5 11 1d 2b 71 7f 101 1c1 a81 1421 10001 f0f0f1 ae98501 cab258ee1 "
+    "145fd73cb5ec1" },
+  { 225,
+    "7 1f 49 97 259 277 709 5b0f 189c1 1c201 96bb9 a13e21 505c009f "
+    "313ed7a898cdd7" },
+  { 226,
+    "3 e3 d3f 5aef beb1 101c9 1c8319 25eb7d31 3ca43f3d97c6f 6d064f6854ef3b9" },
+  { 227, "5fdfed62595479 155c784c845ff0b4ac9fb257cab00e8762c453cb2a37" },
+  { 228,
+    "3 3 5 7 d e5 1c9 23b 7e79 2001d 274c9 2aaab 7ffff 80401 1281af 9908251 "
+    "4020080401" },
+  { 229, "16f349 138b1d1 d4923669e20bc7 15fee101f81a2b4f54ab0691b734b7bf1" },
+  { 230,
+    "3 b 1f 2f 2b3 3a67 2b931 2aaaab 3d9961 704d23e3 13a793e2b023b "
+    "966fc18022f69" },
+  { 231,
+    "7 7 17 59 7f 151 1cf 925b7 8112264cd9bb77f f5a6b315159afdd33c14321357c9" },
+  { 232,
+    "3 5 11 3b e9 44f 829 e801 2e4851 6664ccd 20008001 "
+    "109dc950da32fc88e84d688f1" },
+  { 233, "577 211b7 97ff1 4c429036602121c057e1bfa2bac5eda6fe9519726ff5dff" },
+  { 234,
+    "3 3 3 7 13 49 4f 3a9 aab 1999 1fff 15061 1da19 1554aab 1d2b61f99 "
+    "11f7047dc0fb823ee09" },
+  { 235,
+    "1f 92f 11a1 ca6691 8e8891c1 10d531cc81 e1926ed6128547b6bb60d4f57721f" },
+  { 236,
+    "3 5 49d b11 dd5 9133 267d1 2ab1d 2beef 54411d 6cc31c19 184eae8935 "
+    "2e9db69cff1" },
+  { 237,
+    "7 58f a7f c091 c0aba87 103413e6cb7 1494db743874c043f 1b32bc4fbfeee9177" },
+  { 238,
+    "3 2b 7f ef 4f07 aaab 1ffff 31185ac3 eaa150caf 1e867bff69 "
+    "7c2c78f98ab3c5141" },
+  { 239,
+    "1df 779 1669 2b0ff 7fcafe1 4dd67d1493fea12958c3add8582f926b6ef55ab9f" },
+  { 240,
+    "3 3 5 5 7 b d 11 1f 29 3d 61 97 f1 101 14b 2a1 529 f0f1 1787ebc1 "
+    "ff00ff01 10feef011 aebfa6541" },
+  { 241, "14fb319 18671be8a0f2d03da7c731ed61ec65beded6639928a4035308e06d7" },
+  { 242,
+    "3 17 59 2ab 2d7 1ca7b 23b7cea2fc7b5aae1c22ecb3 "
+    "168c2661efceb3c3748ef748e7" },
+  { 243,
+    "7 49 1e7 a21 115cf 40201 5d2914f f3ccb523cf1 af81b9f82201 "
+    "338730e1971add47" },
+  { 244,
+    "3 5 2dd 6ad 34beed 55b6e37895 9b4f994ee5 aaaaaaaaaaaaaab "
+    "1fffffffffffffff" },
+  { 245,
+    "1f 47 7f 5bf 1e029 40810204081 2c34359a0a0cf6f34c64f2ed12f7fef3ff4dcabf" },
+  { 246,
+    "3 3 7 53 2e3 3437 285c1 3b4fc7 9ce3e79 20e64c149 2ee02988427bd9 "
+    "2776572c79ed291" },
+  { 247,
+    "1fff 3dc1 7ffff 5dffc61f799 16d9edff3d3df 3f3f6a6df6aaf53391d306a553c9" },
+  { 248,
+    "3 5 11 15cd 21e9 c145 46f61 5df05 2aaaaaab 7fffffff e0b8ba11 "
+    "3de3499af7082c6981" },
+  { 249,
+    "7 a7 60a37371 c4372f855d824ca58e9 183849667bffb90318de04d5837d2f8fa7" },
+  { 250,
+    "3 b 1f fb 259 709 fd3 db0759b 3ea70096b1 41606b48636df251 "
+    "12b363f587d62c8e893" },
+  { 251,
+    "1f7 d3c9 9a9712deaaa1684a7 d0f82af0d961c52eeb7 9fc017ceb027aae561591" },
+  { 252,
+    "3 3 3 5 7 7 d 13 1d 25 2b 49 6d 71 7f 151 595 152b 3871 16a41 9e9b9 "
+    "967573165 11f703ee09 1ba60eb3ad" },
+  { 253,
+    "17 17 2f 59 2b931 f491afb9 2a57bb0909385b4233a9 "
+    "233c9292d6315aeb68bfa2aed39" },
+  { 254,
+    "3 2aaaaaaaaaaaaaaaaaaaaaaaaaaaaaab 7fffffffffffffffffffffffffffffff" },
+  { 255,
+    "7 1f 67 97 85f 2b6f 1a05f 1ffff e7b77 84214a52b5ad7bdf "
+    "126cf51772d253cba3f5a7cf" },
+  { 256,
+    "3 5 11 101 281 10001 42f01 663d81 3d30f19cd101 d3eafc3af14601 "
+    "13540775b48cc32ba01" },
+  { 512,
+    "3 5 11 101 281 10001 42f01 663d81 3d30f19cd101 466cc05aee801 "
+    "d3eafc3af14601 13540775b48cc32ba01 "
+    "3a294c585a8f5c7073e36ee3637cab2586d049baa0ba2c911801" },
+  { 1024,
+    "3 5 11 101 281 10001 42f01 250001 663d81 3d30f19cd101 466cc05aee801 "
+    "d3eafc3af14601 13540775b48cc32ba01 "
+    "519f0cb14cf36cfcda7d08fab2b578314c9542801 "
+    "3a294c585a8f5c7073e36ee3637cab2586d049baa0ba2c911801 15b363d6813950b9e8c"
+    "ae31e65cd31be62654b166786c86eca58c2ffe48aa9ea327a500b6ae44c6d801" },
+  { 2048,
+    "3 5 11 101 281 10001 42f01 250001 663d81 2b7b001 182a84001 3d30f19cd101 "
+    "466cc05aee801 d3eafc3af14601 13540775b48cc32ba01 "
+    "db1a02c00e3cc7610a12cbca4441fb001 "
+    "519f0cb14cf36cfcda7d08fab2b578314c9542801 "
+    "3a294c585a8f5c7073e36ee3637cab2586d049baa0ba2c911801 15b363d6813950b9e8c"
+    "ae31e65cd31be62654b166786c86eca58c2ffe48aa9ea327a500b6ae44c6d801 48dfcd5"
+    "a515efc2c791cc8aa67814e7e2392c921dd5711a8f7f79df5787220610acca470533d4c7"
+    "a8f5124cabda661efce3417562d7d236ed4e6a37977025b9de734bc8b31cc52b0618d89f"
+    "86fb78b0e4b1063d88b82851a1edef8ce08077e98dd34c6810e9806001" },
+  { 4096,
+    "3 5 11 101 281 10001 42f01 4e001 ee001 250001 663d81 2b7b001 182a84001 "
+    "3d30f19cd101 466cc05aee801 d3eafc3af14601 91b4f3df38953c001 "
+    "c1089bbfc374aae001 13540775b48cc32ba01 "
+    "db1a02c00e3cc7610a12cbca4441fb001 "
+    "519f0cb14cf36cfcda7d08fab2b578314c9542801 "
+    "3a294c585a8f5c7073e36ee3637cab2586d049baa0ba2c911801 15b363d6813950b9e8c"
+    "ae31e65cd31be62654b166786c86eca58c2ffe48aa9ea327a500b6ae44c6d801 48dfcd5"
+    "a515efc2c791cc8aa67814e7e2392c921dd5711a8f7f79df5787220610acca470533d4c7"
+    "a8f5124cabda661efce3417562d7d236ed4e6a37977025b9de734bc8b31cc52b0618d89f"
+    "86fb78b0e4b1063d88b82851a1edef8ce08077e98dd34c6810e9806001 839c858de1328"
+    "df2c2b972c76a75b452f403ff69810ea6231969033841bc4bd0230e7632be6e703e1b0e5"
+    "4efe7d711b1591cfaf6c763255425203a66bfffa8003d3d3beafef433a26347f4316d13d"
+    "4d943435a6fe5ff46caef263e7ee627a4733002e8f283113fe35e38a69d436d75a483314"
+    "cdd19523d740f328e1a55e19d1101311a27ebbe8f97fa67ad605e34a80a587b458aacddf"
+    "129586abf4781fe82bc5b0c249f74aa0c5ad8db5afff1d0b31f4a4767f0e76f890f8d423"
+    "0648637fa6492b701e829237e235e358a509cb37364366832d9258ab32d006fc6b8a7bda"
+    "0da2322ceca31a681eda001" },
+};
+
+/// n for which 2^n-1 is prime
+inline constexpr int prime_exponents[] = { 2,    3,    5,    7,    13,   17,
+                                           19,   31,   61,   89,   107,  127,
+                                           521,  607,  1279, 2203, 2281, 3217,
+                                           4253, 4423, 9689, 9941 };
+} // namespace detail::mersenne
+
+/**
+ * the prime factors of 2^n-1 as space separated hex numbers, an empty string
+ * if 2^n-1 is prime, or nothing if the factorization is not known.
+ */
+constexpr std::optional<std::string_view>
+mersenne_factors(const int n)
+{
+  using namespace detail::mersenne;
+  if (std::binary_search(std::begin(prime_exponents),
+                         std::end(prime_exponents),
+                         n)) {
+    return std::string_view{};
+  }
+  const auto it = std::lower_bound(
+    std::begin(factorizations),
+    std::end(factorizations),
+    n,
+    [](const Factorization& f, const int value) { return f.n < value; });
+  if (it == std::end(factorizations) || it->n != n) {
+    return std::nullopt;
+  }
+  return it->factors;
+}
+
+/// parses space separated hex numbers, as returned by mersenne_factors()
+template<int M>
+std::vector<BigNum<M, std::uint64_t>>
+parse_factors(std::string_view hex)
+{
+  std::vector<BigNum<M, std::uint64_t>> ret;
+  while (!hex.empty()) {
+    const auto end = std::min(hex.find(' '), hex.size());
+    BigNum<M, std::uint64_t> value;
+    for (std::size_t i = 0; i < end; ++i) {
+      const char c = hex[end - 1 - i];
+      const int digit = c <= '9' ? c - '0' : c - 'a' + 10;
+      if (digit < 0 || digit > 15) {
+        throw std::invalid_argument("bad hex digit in factor");
+      }
+      for (std::size_t b = 0; b < 4; ++b) {
+        if ((digit >> b) & 1) {
+          if (4 * i + b >= static_cast<std::size_t>(M)) {
+            throw std::invalid_argument("factor is too large");
+          }
+          value.set_bit_to(4 * i + b, true);
+        }
+      }
+    }
+    ret.push_back(value);
+    hex.remove_prefix(std::min(end + 1, hex.size()));
+  }
+  return ret;
+}
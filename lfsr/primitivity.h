@@ -0,0 +1,254 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "bignum.h"
+#include "gf2poly.h"
+
+/*
+ * tests for whether a polynomial P over GF(2) gives a maximal length LFSR,
+ * which is the case if it is primitive. P of degree n is primitive if it is
+ * irreducible and x has order 2^n-1 modulo P.
+ */
+
+namespace detail {
+/// the polynomial P itself, including the leading term
+template<int N>
+using Gf2Polynomial = std::array<std::uint64_t, Gf2Modulus<N>::Words + 1>;
+
+template<std::size_t Nwords>
+constexpr int
+poly_degree(const std::array<std::uint64_t, Nwords>& a)
+{
+  for (int i = static_cast<int>(Nwords) - 1; i >= 0; --i) {
+    if (a[i] != 0) {
+      return 64 * i + 63 - std::countl_zero(a[i]);
+    }
+  }
+  return -1;
+}
+
+/// a ^= b*x^shift, terms beyond the end of a are dropped
+template<std::size_t Nwords>
+constexpr void
+xor_shifted(std::array<std::uint64_t, Nwords>& a,
+            const std::array<std::uint64_t, Nwords>& b,
+            const int shift)
+{
+  const int words = shift / 64;
+  const int bits = shift % 64;
+  for (int i = static_cast<int>(Nwords) - 1; i >= words; --i) {
+    std::uint64_t v = b[i - words] << bits;
+    if (bits != 0 && i - words - 1 >= 0) {
+      v |= b[i - words - 1] >> (64 - bits);
+    }
+    a[i] ^= v;
+  }
+}
+
+/// greatest common divisor of two polynomials, with euclid's algorithm
+template<std::size_t Nwords>
+constexpr std::array<std::uint64_t, Nwords>
+poly_gcd(std::array<std::uint64_t, Nwords> a,
+         std::array<std::uint64_t, Nwords> b)
+{
+  while (poly_degree(b) >= 0) {
+    const int db = poly_degree(b);
+    for (int da = poly_degree(a); da >= db; da = poly_degree(a)) {
+      xor_shifted(a, b, da - db);
+    }
+    std::swap(a, b);
+  }
+  return a;
+}
+
+template<int N>
+constexpr Gf2Polynomial<N>
+full_polynomial(const Gf2Modulus<N>& m)
+{
+  Gf2Polynomial<N> p{};
+  std::copy(m.low().m_data.begin(), m.low().m_data.end(), p.begin());
+  p[m.degree() / 64] |= std::uint64_t{ 1U } << (m.degree() % 64);
+  return p;
+}
+
+/// true if gcd(a, P) is 1, where a is reduced modulo P
+template<int N>
+constexpr bool
+is_coprime(const Gf2Modulus<N>& m, const typename Gf2Modulus<N>::Element& a)
+{
+  Gf2Polynomial<N> h{};
+  std::copy(a.m_data.begin(), a.m_data.end(), h.begin());
+  return poly_degree(poly_gcd(full_polynomial(m), h)) == 0;
+}
+
+template<int N>
+constexpr typename Gf2Modulus<N>::Element
+x_of(const Gf2Modulus<N>& m)
+{
+  return m.multiply_by_x(m.one());
+}
+
+/// a^(2^k)
+template<int N>
+constexpr typename Gf2Modulus<N>::Element
+repeated_square(const Gf2Modulus<N>& m,
+                typename Gf2Modulus<N>::Element a,
+                const int k)
+{
+  for (int i = 0; i < k; ++i) {
+    a = m.square(a);
+  }
+  return a;
+}
+} // namespace detail
+
+/**
+ * true if P has an irreducible factor of degree at most maxdegree. it is much
+ * cheaper than is_irreducible() for small maxdegree, and most polynomials
+ * have a small factor, so it is useful for sieving candidates.
+ *
+ * the irreducible polynomials of degree d are the factors of x^(2^d)-x, so
+ * the product of x^(2^d)-x for d=1..maxdegree shares a factor with P if and
+ * only if P has such a factor. only one gcd is needed.
+ */
+template<int N>
+constexpr bool
+has_small_factor(const Gf2Modulus<N>& m, const int maxdegree)
+{
+  const auto x = detail::x_of(m);
+  auto y = x;
+  auto product = m.one();
+  for (int d = 1; d <= std::min(maxdegree, m.degree() / 2); ++d) {
+    y = m.square(y);
+    auto h = y;
+    for (int i = 0; i < Gf2Modulus<N>::Words; ++i) {
+      h.m_data[i] ^= x.m_data[i];
+    }
+    product = m.multiply(product, h);
+  }
+  return !detail::is_coprime(m, product);
+}
+
+/**
+ * rabin's test: P of degree n is irreducible if and only if x^(2^n) = x mod P
+ * and gcd(x^(2^(n/q)) - x, P) = 1 for all primes q dividing n.
+ */
+template<int N>
+constexpr bool
+is_irreducible(const Gf2Modulus<N>& m)
+{
+  const int n = m.degree();
+  const auto x = detail::x_of(m);
+  if (detail::repeated_square(m, x, n).m_data != x.m_data) {
+    return false;
+  }
+  int remaining = n;
+  for (int q = 2; q <= remaining; ++q) {
+    if (remaining % q != 0) {
+      continue;
+    }
+    while (remaining % q == 0) {
+      remaining /= q;
+    }
+    if (q == n) {
+      break;
+    }
+    auto h = detail::repeated_square(m, x, n / q);
+    for (int i = 0; i < Gf2Modulus<N>::Words; ++i) {
+      h.m_data[i] ^= x.m_data[i];
+    }
+    if (!detail::is_coprime(m, h)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+namespace detail {
+/// base^exponent, left to right square and multiply
+template<int N, int M>
+constexpr typename Gf2Modulus<N>::Element
+power(const Gf2Modulus<N>& m,
+      const typename Gf2Modulus<N>::Element& base,
+      const BigNum<M, std::uint64_t>& exponent)
+{
+  auto ret = m.one();
+  int bit = M - 1;
+  while (bit >= 0 && !exponent.ith_bit(bit)) {
+    --bit;
+  }
+  for (; bit >= 0; --bit) {
+    ret = m.square(ret);
+    if (exponent.ith_bit(bit)) {
+      ret = m.multiply(ret, base);
+    }
+  }
+  return ret;
+}
+
+/**
+ * verifies that y raised to the product of all factors but one differs from
+ * one, for each factor. the factors are split in halves and y is raised to
+ * one half before recursing into the other, so each factor is used
+ * O(log(factors)) times instead of O(factors) times.
+ */
+template<int N, int M>
+constexpr bool
+all_cofactor_powers_differ_from_one(
+  const Gf2Modulus<N>& m,
+  const typename Gf2Modulus<N>::Element& y,
+  std::span<const BigNum<M, std::uint64_t>> factors)
+{
+  if (factors.size() == 1) {
+    return y.m_data != m.one().m_data;
+  }
+  const auto left = factors.first(factors.size() / 2);
+  const auto right = factors.subspan(factors.size() / 2);
+  auto yleft = y;
+  for (const auto& f : right) {
+    yleft = power(m, yleft, f);
+  }
+  if (!all_cofactor_powers_differ_from_one(m, yleft, left)) {
+    return false;
+  }
+  auto yright = y;
+  for (const auto& f : left) {
+    yright = power(m, yright, f);
+  }
+  return all_cofactor_powers_differ_from_one(m, yright, right);
+}
+} // namespace detail
+
+/**
+ * true if x has order 2^n-1 modulo P, which holds if x^((2^n-1)/p) != 1 for
+ * every prime p dividing 2^n-1. P must be irreducible.
+ * @param factors the prime factors of 2^n-1, repeated factors are allowed.
+ * empty means 2^n-1 is prime.
+ */
+template<int N, int M>
+constexpr bool
+has_maximal_order(const Gf2Modulus<N>& m,
+                  std::span<const BigNum<M, std::uint64_t>> factors)
+{
+  const auto x = detail::x_of(m);
+  if (factors.empty()) {
+    return x.m_data != m.one().m_data;
+  }
+  return detail::all_cofactor_powers_differ_from_one(m, x, factors);
+}
+
+/// true if P is primitive, see has_maximal_order() for the factors
+template<int N, int M>
+constexpr bool
+is_primitive(const Gf2Modulus<N>& m,
+             std::span<const BigNum<M, std::uint64_t>> factors)
+{
+  return !has_small_factor(m, 16) && is_irreducible(m) &&
+         has_maximal_order(m, factors);
+}
@@ -1,4 +1,10 @@
 #include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <type_traits>
+#include <unordered_set>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -176,7 +182,6 @@ TEST_CASE("a bignum can be right shifted one bit")
   REQUIRE(big.popcount() == 0);
 }
 
-/* no need to provide this
 TEST_CASE("a bignum can be compared with == and !=")
 {
   BigNum<1234> a;
@@ -185,7 +190,59 @@ TEST_CASE("a bignum can be compared with == and !=")
   b.set_bit_to(12, true);
   REQUIRE(a != b);
 }
-*/
+
+TEST_CASE("a bignum is ordered as an unsigned integer")
+{
+  BigNum<200, std::uint64_t> small;
+  BigNum<200, std::uint64_t> large;
+  small.set_bit_to(130, true);
+  large.set_bit_to(131, true);
+  REQUIRE(small < large);
+  small.set_bit_to(0, true);
+  small.set_bit_to(64, true);
+  REQUIRE(small < large);
+  REQUIRE(large > small);
+  REQUIRE((small <=> small) == std::strong_ordering::equal);
+}
+
+TEST_CASE("bitwise operators")
+{
+  BigNum<100, std::uint8_t> a;
+  BigNum<100, std::uint8_t> b;
+  a.set_bit_to(3, true);
+  a.set_bit_to(99, true);
+  b.set_bit_to(3, true);
+  b.set_bit_to(50, true);
+
+  REQUIRE((a & b).popcount() == 1);
+  REQUIRE((a | b).popcount() == 3);
+  REQUIRE((a ^ b).popcount() == 2);
+  REQUIRE((~a).popcount() == 98);
+  REQUIRE((a >> 96).ith_bit(3));
+  REQUIRE((a << 1).popcount() == 1);
+  REQUIRE((a << 1).ith_bit(4));
+  REQUIRE(((a ^ b) ^ b) == a);
+
+  auto c = a;
+  c <<= 50;
+  c >>= 50;
+  REQUIRE(c.popcount() == 1);
+  REQUIRE(c.ith_bit(3));
+}
+
+TEST_CASE("a bignum can be hashed")
+{
+  std::unordered_set<BigNum<300, std::uint64_t>> set;
+  BigNum<300, std::uint64_t> a;
+  for (int i = 0; i < 300; ++i) {
+    a.set_bit_to(i, true);
+    set.insert(a);
+    set.insert(a);
+  }
+  REQUIRE(set.size() == 300);
+  REQUIRE(std::hash<BigNum<300, std::uint64_t>>{}(a) ==
+          std::hash<BigNum<300, std::uint64_t>>{}(a));
+}
 
 TEST_CASE("a bignum can be converted to uint64")
 {
@@ -219,3 +276,143 @@ TEST_CASE("a bignum can be converted to uint64")
     REQUIRE(b == (1ULL << 10) + (1ULL << 50));
   }
 }
+
+TEST_CASE("the limb type is selected from the size")
+{
+  static_assert(std::is_same_v<DefaultLimb_t<3>, std::uint8_t>);
+  static_assert(std::is_same_v<DefaultLimb_t<16>, std::uint16_t>);
+  static_assert(std::is_same_v<DefaultLimb_t<17>, std::uint32_t>);
+  static_assert(std::is_same_v<DefaultLimb_t<64>, std::uint64_t>);
+  static_assert(std::is_same_v<DefaultLimb_t<65>, std::uint64_t>);
+  static_assert(BigNum<168>::LimbCount == 3);
+}
+
+namespace {
+template<int N, typename Limb>
+void
+verifyDirtyExcessBits()
+{
+  // complement and shift_left leave the excess bits set
+  BigNum<N, Limb> ones;
+  ones.complement_in_place();
+  BigNum<N, Limb> clean;
+  for (int i = 0; i < N; ++i) {
+    clean.set_bit_to(i, true);
+  }
+  REQUIRE(ones == clean);
+  REQUIRE((ones <=> clean) == std::strong_ordering::equal);
+  REQUIRE(ones.popcount() == N);
+  REQUIRE(ones.masked_parity(ones) == (N % 2 == 1));
+  REQUIRE(std::hash<BigNum<N, Limb>>{}(ones) ==
+          std::hash<BigNum<N, Limb>>{}(clean));
+  REQUIRE(ones.normalized().m_data == clean.m_data);
+
+  auto shifted = ones << 1;
+  shifted.set_bit_to(0, true);
+  REQUIRE(shifted == clean);
+
+  // shifting right must not bring them back
+  auto r = ones;
+  r >>= 1;
+  REQUIRE(r.popcount() == N - 1);
+  REQUIRE_FALSE(r.ith_bit(N - 1));
+}
+} // namespace
+
+TEST_CASE("dirty excess bits are not observable")
+{
+  verifyDirtyExcessBits<3, std::uint8_t>();
+  verifyDirtyExcessBits<100, std::uint8_t>();
+  verifyDirtyExcessBits<100, std::uint32_t>();
+  verifyDirtyExcessBits<100, std::uint64_t>();
+  verifyDirtyExcessBits<128, std::uint64_t>();
+  verifyDirtyExcessBits<1000, std::uint64_t>();
+  REQUIRE(to_uint64(~BigNum<10, std::uint8_t>{}) == 1023);
+}
+
+namespace {
+template<int N, typename Limb>
+BigNum<N, Limb>
+random_bignum(std::mt19937_64& rng)
+{
+  BigNum<N, Limb> ret;
+  for (int i = 0; i < N; ++i) {
+    ret.set_bit_to(i, rng() & 1U);
+  }
+  return ret;
+}
+
+/// compares the bit operations against doing it one bit at a time
+template<int N, typename Limb>
+void
+verifyBitOperations()
+{
+  std::mt19937_64 rng(N);
+  for (int iter = 0; iter < 20; ++iter) {
+    const auto a = random_bignum<N, Limb>(rng);
+    const auto b = random_bignum<N, Limb>(rng);
+
+    int popcount = 0;
+    bool parity = false;
+    for (int i = 0; i < N; ++i) {
+      popcount += a.ith_bit(i);
+      parity ^= a.ith_bit(i) && b.ith_bit(i);
+    }
+    REQUIRE(a.popcount() == popcount);
+    REQUIRE(a.masked_parity(b) == parity);
+
+    auto x = a;
+    x.xor_with(b);
+    auto y = a;
+    y.and_with(b);
+    for (int i = 0; i < N; ++i) {
+      REQUIRE(x.ith_bit(i) == (a.ith_bit(i) != b.ith_bit(i)));
+      REQUIRE(y.ith_bit(i) == (a.ith_bit(i) && b.ith_bit(i)));
+    }
+
+    for (const int shift : { 0, 1, 7, 63, 64, 65, N / 2, N - 1, N, N + 1 }) {
+      auto r = a;
+      r.shift_right(shift);
+      auto l = a;
+      l.shift_left(shift);
+      for (int i = 0; i < N; ++i) {
+        REQUIRE(r.ith_bit(i) == (i + shift < N && a.ith_bit(i + shift)));
+        REQUIRE(l.ith_bit(i) == (i >= shift && a.ith_bit(i - shift)));
+      }
+      // bits shifted into the excess bits must not be counted
+      REQUIRE(l.popcount() <= N);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("bit operations agree with the bitwise reference")
+{
+  verifyBitOperations<3, std::uint8_t>();
+  verifyBitOperations<100, std::uint8_t>();
+  verifyBitOperations<100, std::uint16_t>();
+  verifyBitOperations<100, unsigned>();
+  verifyBitOperations<64, std::uint64_t>();
+  verifyBitOperations<100, std::uint64_t>();
+  verifyBitOperations<128, std::uint64_t>();
+  verifyBitOperations<256, std::uint64_t>();
+  verifyBitOperations<512, std::uint64_t>();
+  verifyBitOperations<520, std::uint64_t>();
+  verifyBitOperations<1000, std::uint64_t>();
+  verifyBitOperations<1000, unsigned>();
+  verifyBitOperations<1234, std::uint64_t>();
+}
+
+TEST_CASE("bit operations work in constexpr context")
+{
+  constexpr auto shifted = [] {
+    BigNum<200, std::uint64_t> big;
+    big.set_bit_to(3, true);
+    big.shift_left(130);
+    big.shift_right(2);
+    return big;
+  }();
+  static_assert(shifted.ith_bit(131));
+  static_assert(shifted.popcount() == 1);
+  static_assert(shifted.masked_parity(shifted));
+}
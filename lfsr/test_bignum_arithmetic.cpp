@@ -0,0 +1,211 @@
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "bignum_arithmetic.h"
+
+namespace {
+/// a slow but simple reference: base 2^16 digits, least significant first
+using Reference = std::vector<std::uint32_t>;
+
+template<int N, typename Limb>
+Reference
+to_reference(const BigNum<N, Limb>& a)
+{
+  Reference ret((N + 15) / 16);
+  for (int i = 0; i < N; ++i) {
+    ret[i / 16] |= std::uint32_t{ a.ith_bit(i) } << (i % 16);
+  }
+  return ret;
+}
+
+/// truncates to the given number of bits and removes leading zeros
+Reference
+normalize(Reference a, const int nbits)
+{
+  a.resize((nbits + 15) / 16);
+  if (nbits % 16 != 0) {
+    a.back() &= (1U << (nbits % 16)) - 1U;
+  }
+  while (!a.empty() && a.back() == 0) {
+    a.pop_back();
+  }
+  return a;
+}
+
+Reference
+reference_add(const Reference& a, const Reference& b)
+{
+  Reference ret(std::max(a.size(), b.size()) + 1);
+  std::uint32_t carry = 0;
+  for (std::size_t i = 0; i < ret.size(); ++i) {
+    const auto t =
+      (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0) + carry;
+    ret[i] = t & 0xFFFF;
+    carry = t >> 16;
+  }
+  return ret;
+}
+
+/// a-b, wrapping around at 2^(16*size)
+Reference
+reference_subtract(const Reference& a, const Reference& b)
+{
+  Reference ret(std::max(a.size(), b.size()));
+  std::uint32_t borrow = 0;
+  for (std::size_t i = 0; i < ret.size(); ++i) {
+    const auto t = 0x10000 + (i < a.size() ? a[i] : 0) -
+                   (i < b.size() ? b[i] : 0) - borrow;
+    ret[i] = t & 0xFFFF;
+    borrow = t < 0x10000;
+  }
+  return ret;
+}
+
+Reference
+reference_multiply(const Reference& a, const Reference& b)
+{
+  Reference ret(a.size() + b.size() + 1);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    std::uint64_t carry = 0;
+    for (std::size_t j = 0; j < b.size(); ++j) {
+      const std::uint64_t t =
+        std::uint64_t{ a[i] } * b[j] + ret[i + j] + carry;
+      ret[i + j] = t & 0xFFFF;
+      carry = t >> 16;
+    }
+    for (std::size_t k = i + b.size(); carry != 0; ++k) {
+      const std::uint64_t t = ret[k] + carry;
+      ret[k] = t & 0xFFFF;
+      carry = t >> 16;
+    }
+  }
+  return ret;
+}
+
+template<int N, typename Limb>
+BigNum<N, Limb>
+random_bignum(std::mt19937_64& rng)
+{
+  BigNum<N, Limb> ret;
+  // sometimes use fewer bits, to get carries and borrows of all kinds
+  const int nbits = rng() % 4 == 0 ? static_cast<int>(rng() % N) : N;
+  for (int i = 0; i < nbits; ++i) {
+    ret.set_bit_to(i, rng() & 1U);
+  }
+  if (rng() % 8 == 0) {
+    ret.complement_in_place();
+  }
+  return ret;
+}
+
+template<int N, typename Limb>
+void
+verify_against_reference()
+{
+  std::mt19937_64 rng(N * sizeof(Limb));
+  for (int iter = 0; iter < 50; ++iter) {
+    const auto a = random_bignum<N, Limb>(rng);
+    const auto b = random_bignum<N, Limb>(rng);
+    const auto ra = to_reference(a);
+    const auto rb = to_reference(b);
+
+    const auto sum = reference_add(ra, rb);
+    REQUIRE(normalize(to_reference(a + b), N) == normalize(sum, N));
+    auto c = a;
+    // the sum overflowed if it has any bit set at position N
+    REQUIRE(add_in_place(c, b) != (normalize(sum, N + 1) == normalize(sum, N)));
+
+    REQUIRE(normalize(to_reference(a - b), N) ==
+            normalize(reference_subtract(ra, rb), N));
+    c = a;
+    REQUIRE(subtract_in_place(c, b) == (b > a));
+
+    const auto product = reference_multiply(ra, rb);
+    REQUIRE(normalize(to_reference(multiply(a, b)), 2 * N) ==
+            normalize(product, 2 * N));
+    REQUIRE(normalize(to_reference(a * b), N) == normalize(product, N));
+
+    auto divisor = static_cast<Limb>(rng());
+    if (divisor == 0) {
+      divisor = 1;
+    }
+    const auto [quotient, remainder] = divide(a, divisor);
+    REQUIRE(remainder < divisor);
+    BigNum<N, Limb> d;
+    d.m_data[0] = divisor;
+    BigNum<N, Limb> r;
+    r.m_data[0] = remainder;
+    const auto qd = reference_multiply(to_reference(quotient), to_reference(d));
+    REQUIRE(normalize(reference_add(qd, to_reference(r)), 2 * N) ==
+            normalize(ra, N));
+  }
+}
+} // namespace
+
+TEST_CASE("arithmetic agrees with the reference for random inputs")
+{
+  verify_against_reference<8, std::uint8_t>();
+  verify_against_reference<100, std::uint8_t>();
+  verify_against_reference<1000, std::uint8_t>();
+  verify_against_reference<100, std::uint16_t>();
+  verify_against_reference<64, std::uint32_t>();
+  verify_against_reference<1000, std::uint32_t>();
+  verify_against_reference<64, std::uint64_t>();
+  verify_against_reference<100, std::uint64_t>();
+  verify_against_reference<128, std::uint64_t>();
+  verify_against_reference<2000, std::uint64_t>();
+  verify_against_reference<4096, std::uint64_t>();
+}
+
+TEST_CASE("karatsuba agrees with schoolbook")
+{
+  std::mt19937_64 rng;
+  auto check = [&]<std::size_t n>() {
+    std::array<std::uint64_t, n> a;
+    std::array<std::uint64_t, n> b;
+    for (std::size_t i = 0; i < n; ++i) {
+      a[i] = rng();
+      b[i] = rng();
+    }
+    // all ones gives the most carries
+    if (rng() % 2 == 0) {
+      a.fill(~std::uint64_t{});
+      b.fill(~std::uint64_t{});
+    }
+    std::array<std::uint64_t, 2 * n> expected;
+    std::array<std::uint64_t, 2 * n> actual;
+    detail::multiply_schoolbook<n>(a.data(), b.data(), expected.data());
+    detail::multiply_karatsuba<n>(a.data(), b.data(), actual.data());
+    REQUIRE(actual == expected);
+  };
+  for (int iter = 0; iter < 10; ++iter) {
+    check.operator()<detail::KaratsubaThreshold>();
+    check.operator()<detail::KaratsubaThreshold + 1>();
+    check.operator()<37>();
+    check.operator()<64>();
+    check.operator()<99>();
+  }
+}
+
+TEST_CASE("arithmetic works in constexpr context")
+{
+  constexpr auto max = ~BigNum<128, std::uint64_t>{};
+  constexpr BigNum<128, std::uint64_t> one{ { 1 } };
+  static_assert(max + one == BigNum<128, std::uint64_t>{});
+  static_assert(BigNum<128, std::uint64_t>{} - one == max);
+  static_assert(multiply(max, max) ==
+                BigNum<256, std::uint64_t>{ { 1, 0, ~0ULL - 1, ~0ULL } });
+  static_assert(divide(max, std::uint64_t{ 3 }).second == 0);
+  // 2^128 = 2^2 modulo 7, since 2^3 = 1
+  static_assert(divide(max, std::uint64_t{ 7 }).second == 3);
+
+  constexpr auto overflow = [] {
+    auto a = ~BigNum<100, std::uint32_t>{};
+    return add_in_place(a, BigNum<100, std::uint32_t>{ { 1 } });
+  }();
+  static_assert(overflow);
+}
@@ -0,0 +1,99 @@
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "clmul_crc.h"
+#include "lfsr_polynomial.h"
+
+namespace {
+std::span<const std::byte>
+as_bytes(std::string_view s)
+{
+  return std::as_bytes(std::span(s.data(), s.size()));
+}
+
+/// bit by bit reference implementation
+template<int N>
+typename Gf2Modulus<N>::Element
+reference_crc(const Gf2Modulus<N>& m, std::span<const std::byte> data)
+{
+  typename Gf2Modulus<N>::Element r;
+  for (const auto b : data) {
+    for (int i = 7; i >= 0; --i) {
+      r = m.multiply_by_x(r);
+      if ((std::to_integer<unsigned>(b) >> i) & 1U) {
+        for (std::size_t w = 0; w < r.m_data.size(); ++w) {
+          r.m_data[w] ^= m.low().m_data[w];
+        }
+      }
+    }
+  }
+  return r;
+}
+
+template<int N>
+void
+verify_against_reference(const Gf2Modulus<N>& m)
+{
+  std::mt19937_64 rng(N);
+  std::vector<std::byte> data(3000);
+  for (auto& b : data) {
+    b = static_cast<std::byte>(rng());
+  }
+  for (const std::size_t size : { 0, 1, 7, 8, 9, 63, 64, 65, 1000, 3000 }) {
+    const auto message = std::span(data).first(size);
+    ClmulCrc<N> crc(m);
+    crc.update(message);
+    REQUIRE(crc.value().m_data == reference_crc(m, message).m_data);
+  }
+
+  // the result does not depend on how the message is split
+  ClmulCrc<N> crc(m);
+  auto remaining = std::span(data).subspan(0);
+  for (std::size_t chunk = 1; !remaining.empty(); chunk = chunk * 3 + 1) {
+    const auto n = std::min(chunk, remaining.size());
+    crc.update(remaining.first(n));
+    remaining = remaining.subspan(n);
+  }
+  REQUIRE(crc.value().m_data == reference_crc(m, data).m_data);
+}
+} // namespace
+
+TEST_CASE("known crc check values")
+{
+  {
+    // CRC-16/XMODEM
+    Gf2Modulus<16>::Element low;
+    low.m_data[0] = 0x1021;
+    ClmulCrc<16> crc(Gf2Modulus<16>{ low });
+    crc.update(as_bytes("123456789"));
+    REQUIRE(to_uint64(crc.value()) == 0x31C3);
+  }
+  {
+    // CRC-64/ECMA-182
+    Gf2Modulus<64>::Element low;
+    low.m_data[0] = 0x42F0E1EBA9EA3693;
+    ClmulCrc<64> crc(Gf2Modulus<64>{ low });
+    crc.update(as_bytes("1234"));
+    crc.update(as_bytes("56789"));
+    REQUIRE(to_uint64(crc.value()) == 0x6C40DF5F0B497347);
+    crc.reset();
+    crc.update(as_bytes("123456789"));
+    REQUIRE(to_uint64(crc.value()) == 0x6C40DF5F0B497347);
+  }
+}
+
+TEST_CASE("crc from lfsr taps agrees with the reference")
+{
+  verify_against_reference(feedback_modulus<3>());
+  verify_against_reference(feedback_modulus<16>());
+  verify_against_reference(feedback_modulus<32>());
+  verify_against_reference(feedback_modulus<63>());
+  verify_against_reference(feedback_modulus<64>());
+  verify_against_reference(feedback_modulus<65>());
+  verify_against_reference(feedback_modulus<127>());
+  verify_against_reference(feedback_modulus<128>());
+  verify_against_reference(feedback_modulus<168>());
+}
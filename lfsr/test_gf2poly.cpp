@@ -0,0 +1,123 @@
+#include <random>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "gf2poly.h"
+#include "lfsr_polynomial.h"
+
+namespace {
+/// reference multiplication, built from multiply_by_x only
+template<int N>
+typename Gf2Modulus<N>::Element
+reference_multiply(const Gf2Modulus<N>& m,
+                   typename Gf2Modulus<N>::Element a,
+                   const typename Gf2Modulus<N>::Element& b)
+{
+  typename Gf2Modulus<N>::Element ret;
+  for (int i = 0; i < m.degree(); ++i) {
+    if (b.ith_bit(i)) {
+      for (std::size_t w = 0; w < ret.m_data.size(); ++w) {
+        ret.m_data[w] ^= a.m_data[w];
+      }
+    }
+    a = m.multiply_by_x(a);
+  }
+  return ret;
+}
+
+template<int N>
+typename Gf2Modulus<N>::Element
+random_element(std::mt19937_64& rng, const int degree)
+{
+  typename Gf2Modulus<N>::Element ret;
+  for (int i = 0; i < degree; ++i) {
+    ret.set_bit_to(i, rng() & 1U);
+  }
+  return ret;
+}
+
+template<int N>
+void
+verify_against_reference(const int degree)
+{
+  std::mt19937_64 rng(degree);
+  const Gf2Modulus<N> m(random_element<N>(rng, degree), degree);
+  for (int iter = 0; iter < 20; ++iter) {
+    const auto a = random_element<N>(rng, degree);
+    const auto b = random_element<N>(rng, degree);
+    const auto expected = reference_multiply(m, a, b);
+    REQUIRE(m.multiply(a, b).m_data == expected.m_data);
+    REQUIRE(m.multiply(b, a).m_data == expected.m_data);
+    REQUIRE(m.square(a).m_data == reference_multiply(m, a, a).m_data);
+  }
+}
+} // namespace
+
+TEST_CASE("portable clmul agrees with the builtin one")
+{
+  std::mt19937_64 rng;
+  for (int i = 0; i < 1000; ++i) {
+    const auto a = rng();
+    const auto b = rng();
+    const auto expected = detail::clmul_portable(a, b);
+    const auto actual = clmul(a, b);
+    REQUIRE(actual.lo == expected.lo);
+    REQUIRE(actual.hi == expected.hi);
+  }
+}
+
+TEST_CASE("clmul can be used in constexpr context")
+{
+  static_assert(clmul(3, 3).lo == 5);
+  static_assert(clmul(~0ULL, 2).lo == ~1ULL);
+  static_assert(clmul(~0ULL, 2).hi == 1);
+}
+
+TEST_CASE("multiplication agrees with the reference")
+{
+  verify_against_reference<1>(1);
+  verify_against_reference<16>(16);
+  verify_against_reference<63>(63);
+  verify_against_reference<64>(64);
+  verify_against_reference<65>(65);
+  verify_against_reference<168>(168);
+  verify_against_reference<256>(200);
+  verify_against_reference<256>(256);
+  verify_against_reference<1000>(999);
+}
+
+TEST_CASE("x to the power of k")
+{
+  const auto m = feedback_modulus<127>();
+  auto expected = m.one();
+  for (std::uint64_t k = 0; k < 300; ++k) {
+    REQUIRE(m.x_to_the(k).m_data == expected.m_data);
+    expected = m.multiply_by_x(expected);
+  }
+}
+
+TEST_CASE("x has maximal order for a maximal length LFSR")
+{
+  // 2^127-1 is prime, so the order of x is either 1 or 2^127-1
+  const auto m = characteristic_modulus<127>();
+  auto x = m.multiply_by_x(m.one());
+  auto power = x;
+  for (int i = 0; i < 127; ++i) {
+    power = m.square(power);
+  }
+  // x^(2^127)=x
+  REQUIRE(power.m_data == x.m_data);
+  REQUIRE(x.m_data != m.one().m_data);
+}
+
+TEST_CASE("taps are converted to polynomials")
+{
+  constexpr auto feedback = feedback_modulus<16>();
+  static_assert(feedback.degree() == 16);
+  // x^16 + x^14 + x^13 + x^11 + 1
+  REQUIRE(to_uint64(feedback.low()) == 0b0110'1000'0000'0001);
+
+  constexpr auto characteristic = characteristic_modulus<16>();
+  // x^16 + x^5 + x^3 + x^2 + 1
+  REQUIRE(to_uint64(characteristic.low()) == 0b10'1101);
+}
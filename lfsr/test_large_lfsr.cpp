@@ -68,3 +68,101 @@ TEST_CASE("test big LSFR (fits in 32 bits) with brute force")
   test_lfsr<17>();
   test_lfsr<18>();
 }
+
+template<std::size_t N, typename Limb>
+void
+test_advance_impl()
+{
+  for (const std::uint64_t steps : { 0, 1, 2, 3, 10, 63, 64, 65, 1000 }) {
+    BigLFSR<N, Limb> stepped;
+    for (std::uint64_t i = 0; i < steps; ++i) {
+      stepped.next();
+    }
+    BigLFSR<N, Limb> advanced;
+    advanced.advance(steps);
+    REQUIRE(advanced.state().m_data == stepped.state().m_data);
+
+    // advancing from a state which is not the initial one
+    stepped.next();
+    advanced.next();
+    stepped.advance(steps);
+    for (std::uint64_t i = 0; i < steps; ++i) {
+      advanced.next();
+    }
+    REQUIRE(advanced.state().m_data == stepped.state().m_data);
+  }
+}
+
+template<std::size_t N>
+void
+test_advance()
+{
+  test_advance_impl<N, std::uint8_t>();
+  test_advance_impl<N, std::uint64_t>();
+}
+
+TEST_CASE("advancing many steps at once is the same as stepping")
+{
+  test_advance<3>();
+  test_advance<16>();
+  test_advance<63>();
+  test_advance<64>();
+  test_advance<65>();
+  test_advance<127>();
+  test_advance<168>();
+}
+
+template<std::size_t N>
+void
+test_full_period()
+{
+  BigLFSR<N, std::uint64_t> lfsr;
+  const auto initial = lfsr.state();
+  constexpr std::uint64_t period = (1ULL << N) - 1;
+  lfsr.advance(period / 3);
+  REQUIRE(lfsr.state().m_data != initial.m_data);
+  lfsr.advance(period - period / 3);
+  REQUIRE(lfsr.state().m_data == initial.m_data);
+}
+
+TEST_CASE("advancing a full period gives back the initial state")
+{
+  test_full_period<20>();
+  test_full_period<32>();
+  test_full_period<48>();
+  test_full_period<63>();
+}
+
+template<std::size_t N, typename Limb>
+void
+test_multi_step_impl()
+{
+  for (const std::size_t steps : { 0, 1, 2, 7, 100, 1000, 5000 }) {
+    BigLFSR<N, Limb> single;
+    for (std::size_t i = 0; i < steps; ++i) {
+      single.next();
+    }
+    BigLFSR<N, Limb> multi;
+    multi.next(steps);
+    REQUIRE(multi.state() == single.state());
+  }
+}
+
+template<std::size_t N>
+void
+test_multi_step()
+{
+  test_multi_step_impl<N, std::uint8_t>();
+  test_multi_step_impl<N, std::uint32_t>();
+  test_multi_step_impl<N, std::uint64_t>();
+}
+
+TEST_CASE("stepping many bits in parallel is the same as stepping")
+{
+  test_multi_step<3>();
+  test_multi_step<16>();
+  test_multi_step<64>();
+  test_multi_step<168>();
+  test_multi_step<521>();
+  test_multi_step<4096>();
+}
@@ -1,4 +1,7 @@
 #include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
 
 #include <catch2/catch_test_macros.hpp>
 
@@ -22,3 +25,33 @@ TEST_CASE("coefficients are ok")
   verify_taps(getTaps<3>());
   verify_taps(getTaps<123>());
 }
+
+TEST_CASE("the packed tap table is consistent")
+{
+  namespace table = detail::taps_table;
+  REQUIRE(std::size(table::first) == std::size(table::nbits) + 1);
+  REQUIRE(std::ranges::adjacent_find(table::nbits, std::greater_equal<>()) ==
+          std::end(table::nbits));
+  REQUIRE(table::first[0] == 0);
+  REQUIRE(table::first[std::size(table::nbits)] == std::size(table::data));
+
+  for (std::size_t i = 0; i < std::size(table::nbits); ++i) {
+    const auto begin = std::begin(table::data) + table::first[i];
+    const auto end = std::begin(table::data) + table::first[i + 1];
+    // at least one tap besides the leading one
+    REQUIRE(begin < end);
+    REQUIRE(*begin < table::nbits[i]);
+    REQUIRE(std::adjacent_find(begin, end, std::less_equal<>()) == end);
+    REQUIRE(*(end - 1) > 0);
+  }
+}
+
+TEST_CASE("taps for large registers")
+{
+  verify_taps(getTaps<169>());
+  verify_taps(getTaps<256>());
+  verify_taps(getTaps<1024>());
+  verify_taps(getTaps<4423>());
+  static_assert(std::is_same_v<decltype(getTaps<4423>()),
+                               std::index_sequence<4423, 4152>>);
+}
@@ -0,0 +1,91 @@
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "lfsr_big.h"
+#include "lfsr_dynamic.h"
+
+namespace {
+/// the output sequence, one step at a time
+std::vector<bool>
+output_by_stepping(DynamicLFSR& lfsr, const std::size_t nbits)
+{
+  std::vector<bool> ret;
+  for (std::size_t i = 0; i < nbits; ++i) {
+    ret.push_back(lfsr.state()[0] & 1U);
+    lfsr.next();
+  }
+  return ret;
+}
+
+std::vector<bool>
+unpack(const std::vector<std::byte>& bytes)
+{
+  std::vector<bool> ret;
+  for (const auto b : bytes) {
+    for (int i = 0; i < 8; ++i) {
+      ret.push_back(std::to_integer<unsigned>(b >> i) & 1U);
+    }
+  }
+  return ret;
+}
+
+template<std::size_t N>
+void
+test_against_big()
+{
+  DynamicLFSR dynamic(N);
+  BigLFSR<N> big;
+  REQUIRE(dynamic.size() == N);
+  for (int i = 0; i < 500; ++i) {
+    const auto state = dynamic.state();
+    for (std::size_t bit = 0; bit < N; ++bit) {
+      REQUIRE(((state[bit / 64] >> (bit % 64)) & 1U) ==
+              big.state().ith_bit(bit));
+    }
+    dynamic.next();
+    big.next();
+  }
+}
+} // namespace
+
+TEST_CASE("every size from 3 to 168 is available")
+{
+  for (std::size_t n = DynamicLFSR::MinSize; n <= DynamicLFSR::MaxSize; ++n) {
+    DynamicLFSR lfsr(n);
+    REQUIRE(lfsr.size() == n);
+    // starts at one, like the compile time classes
+    const auto state = lfsr.state();
+    REQUIRE(state.size() == (n + 63) / 64);
+    REQUIRE(state[0] == 1);
+  }
+  REQUIRE_THROWS_AS(DynamicLFSR(2), std::invalid_argument);
+  REQUIRE_THROWS_AS(DynamicLFSR(169), std::invalid_argument);
+}
+
+TEST_CASE("dynamic LFSR agrees with BigLFSR")
+{
+  test_against_big<3>();
+  test_against_big<17>();
+  test_against_big<64>();
+  test_against_big<65>();
+  test_against_big<168>();
+}
+
+TEST_CASE("fill gives the output sequence")
+{
+  for (std::size_t n = DynamicLFSR::MinSize; n <= DynamicLFSR::MaxSize; ++n) {
+    DynamicLFSR filled(n);
+    DynamicLFSR stepped(n);
+    // odd sizes, to check that consecutive calls continue the sequence
+    for (const std::size_t nbytes : { 1, 3, 40, 7 }) {
+      std::vector<std::byte> bytes(nbytes);
+      filled.fill(bytes);
+      INFO("n=" << n << " nbytes=" << nbytes);
+      REQUIRE(unpack(bytes) == output_by_stepping(stepped, 8 * nbytes));
+      REQUIRE(filled.state() == stepped.state());
+    }
+  }
+}
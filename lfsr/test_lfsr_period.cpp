@@ -0,0 +1,82 @@
+#include <cstdint>
+#include <utility>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "lfsr_period.h"
+
+namespace {
+template<int N>
+Gf2Modulus<N>
+modulus_from_bits(const std::uint64_t lowbits, const int degree)
+{
+  typename Gf2Modulus<N>::Element low;
+  low.m_data[0] = lowbits;
+  return Gf2Modulus<N>(low, degree);
+}
+
+/// the order of x modulo P, by stepping until it comes back to one
+template<int N>
+std::uint64_t
+brute_force_order(const Gf2Modulus<N>& m)
+{
+  auto y = m.multiply_by_x(m.one());
+  std::uint64_t order = 1;
+  while (y.m_data != m.one().m_data) {
+    y = m.multiply_by_x(y);
+    ++order;
+  }
+  return order;
+}
+
+template<std::size_t... N>
+bool
+all_have_maximal_period(std::index_sequence<N...>)
+{
+  return (has_maximal_period<N + 3>() && ...);
+}
+} // namespace
+
+TEST_CASE("period of polynomials which are not primitive")
+{
+  // x^4+x^3+x^2+x+1 divides x^5-1
+  REQUIRE(to_uint64(period_of(modulus_from_bits<64>(0b1111, 4)).value()) == 5);
+  // x^6+x^3+1 divides x^9-1
+  REQUIRE(to_uint64(period_of(modulus_from_bits<64>(0b1001, 6)).value()) == 9);
+  // (x^2+x+1)^2 has period 6, which does not divide 15
+  REQUIRE_FALSE(period_of(modulus_from_bits<64>(0b0101, 4)).has_value());
+}
+
+TEST_CASE("period agrees with brute force for small degrees")
+{
+  for (int n = 2; n <= 12; ++n) {
+    const std::uint64_t maxperiod = (std::uint64_t{ 1 } << n) - 1;
+    for (std::uint64_t lowbits = 1; lowbits < (std::uint64_t{ 1 } << n);
+         lowbits += 2) {
+      const auto m = modulus_from_bits<64>(lowbits, n);
+      const auto order = brute_force_order(m);
+      const auto period = period_of(m);
+      INFO("n=" << n << " P=" << lowbits);
+      if (maxperiod % order == 0) {
+        REQUIRE(to_uint64(period.value()) == order);
+      } else {
+        REQUIRE_FALSE(period.has_value());
+      }
+    }
+  }
+}
+
+TEST_CASE("all taps up to N=168 give the maximal period")
+{
+  REQUIRE(all_have_maximal_period(std::make_index_sequence<168 - 3 + 1>{}));
+}
+
+TEST_CASE("counting the period by stepping")
+{
+  REQUIRE(count_period<3>(1) == 7);
+  REQUIRE(count_period<3>(4) == 7);
+  REQUIRE(count_period<8>(3) == 255);
+  REQUIRE(count_period<16>(1) == 65535);
+  REQUIRE(count_period<16>(5) == 65535);
+  REQUIRE(count_period<22>(4) == (1U << 22) - 1);
+}
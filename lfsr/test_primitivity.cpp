@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <span>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "bignum_arithmetic.h"
+#include "lfsr_taps_table.h"
+#include "mersenne_factors.h"
+#include "primitivity.h"
+
+namespace {
+template<int N>
+Gf2Modulus<N>
+modulus_from_bits(const std::uint64_t lowbits, const int degree)
+{
+  typename Gf2Modulus<N>::Element low;
+  low.m_data[0] = lowbits;
+  return Gf2Modulus<N>(low, degree);
+}
+
+template<int N>
+bool
+is_primitive_from_table(const Gf2Modulus<N>& m)
+{
+  const auto factors = parse_factors<N>(mersenne_factors(m.degree()).value());
+  return is_primitive(m, std::span<const BigNum<N, std::uint64_t>>(factors));
+}
+
+/// the order of x modulo P, by stepping until it comes back to one
+template<int N>
+std::uint64_t
+order_of_x(const Gf2Modulus<N>& m)
+{
+  auto y = m.multiply_by_x(m.one());
+  std::uint64_t order = 1;
+  while (y.m_data != m.one().m_data) {
+    y = m.multiply_by_x(y);
+    ++order;
+  }
+  return order;
+}
+} // namespace
+
+TEST_CASE("mersenne factors")
+{
+  REQUIRE(mersenne_factors(127) == "");
+  REQUIRE(mersenne_factors(64) == "3 5 11 101 281 10001 663d81");
+  REQUIRE_FALSE(mersenne_factors(300).has_value());
+
+  const auto factors = parse_factors<64>("3 663d81");
+  REQUIRE(factors.size() == 2);
+  REQUIRE(factors[0].m_data[0] == 3);
+  REQUIRE(factors[1].m_data[0] == 6700417);
+}
+
+TEST_CASE("mersenne factors multiply to 2^n-1")
+{
+  // one limb more than the largest n, so 2^n fits
+  constexpr int M = 4096 + 64;
+  for (const auto& f : detail::mersenne::factorizations) {
+    BigNum<M, std::uint64_t> product{ { 1 } };
+    for (const auto& factor : parse_factors<M>(f.factors)) {
+      product = product * factor;
+    }
+    BigNum<M, std::uint64_t> expected;
+    expected.set_bit_to(f.n, true);
+    INFO("n=" << f.n);
+    REQUIRE(product + BigNum<M, std::uint64_t>{ { 1 } } == expected);
+  }
+}
+
+TEST_CASE("irreducible but not primitive")
+{
+  // x^4+x^3+x^2+x+1 divides x^5-1
+  const auto m4 = modulus_from_bits<64>(0b1111, 4);
+  REQUIRE_FALSE(has_small_factor(m4, 16));
+  REQUIRE(is_irreducible(m4));
+  REQUIRE_FALSE(is_primitive_from_table(m4));
+
+  // x^6+x^3+1 divides x^9-1
+  const auto m6 = modulus_from_bits<64>(0b1001, 6);
+  REQUIRE(is_irreducible(m6));
+  REQUIRE_FALSE(is_primitive_from_table(m6));
+}
+
+TEST_CASE("reducible")
+{
+  // (x^2+x+1)^2
+  const auto m = modulus_from_bits<64>(0b0101, 4);
+  REQUIRE(has_small_factor(m, 16));
+  REQUIRE_FALSE(is_irreducible(m));
+  REQUIRE_FALSE(is_primitive_from_table(m));
+
+  // (x^3+x+1)(x^5+x^2+1) has no factor of degree 1 or 2
+  const auto m8 = modulus_from_bits<64>(0b01000111, 8);
+  REQUIRE_FALSE(has_small_factor(m8, 2));
+  REQUIRE(has_small_factor(m8, 3));
+  REQUIRE_FALSE(is_irreducible(m8));
+}
+
+TEST_CASE("agrees with brute force for small degrees")
+{
+  for (int n = 2; n <= 12; ++n) {
+    const std::uint64_t period = (std::uint64_t{ 1 } << n) - 1;
+    // P(0) must be one, otherwise x is not invertible
+    for (std::uint64_t lowbits = 1; lowbits < (std::uint64_t{ 1 } << n);
+         lowbits += 2) {
+      const auto m = modulus_from_bits<64>(lowbits, n);
+      REQUIRE(is_primitive_from_table(m) == (order_of_x(m) == period));
+    }
+  }
+}
+
+TEST_CASE("the tap table is primitive")
+{
+  namespace table = detail::taps_table;
+  for (std::size_t i = 0; i < std::size(table::nbits); ++i) {
+    const int n = table::nbits[i];
+    if (n > 256) {
+      continue;
+    }
+    typename Gf2Modulus<256>::Element low;
+    low.set_bit_to(0, true);
+    for (int j = table::first[i]; j < table::first[i + 1]; ++j) {
+      low.set_bit_to(table::data[j], true);
+    }
+    INFO("N=" << n);
+    REQUIRE(is_primitive_from_table(Gf2Modulus<256>(low, n)));
+  }
+}
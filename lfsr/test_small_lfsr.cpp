@@ -3,6 +3,7 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "lfsr_big.h"
 #include "lfsr_small.h"
 
 template<std::size_t N>
@@ -63,3 +64,51 @@ TEST_CASE("test small LSFR (32 bits) with brute force")
 {
   test_lfsr<17>();
 }
+
+template<std::size_t N>
+void
+test_against_big()
+{
+  SmallLFSR<N> small;
+  BigLFSR<N> big;
+  for (int i = 0; i < 10000; ++i) {
+    small.next();
+    big.next();
+    REQUIRE(small.state() == to_uint64(big.state()));
+  }
+}
+
+TEST_CASE("small LFSR agrees with big LFSR above 32 bits")
+{
+  test_against_big<33>();
+  test_against_big<48>();
+  test_against_big<63>();
+  test_against_big<64>();
+}
+
+template<std::size_t N>
+void
+test_multi_step()
+{
+  for (const std::size_t steps : { 0, 1, 2, 3, 7, 64, 65, 1000 }) {
+    SmallLFSR<N> stepped;
+    for (std::size_t i = 0; i < steps; ++i) {
+      stepped.next();
+    }
+    SmallLFSR<N> jumped;
+    jumped.next(steps);
+    REQUIRE(jumped.state() == stepped.state());
+  }
+}
+
+TEST_CASE("stepping many steps at once")
+{
+  test_multi_step<3>();
+  test_multi_step<8>();
+  test_multi_step<16>();
+  test_multi_step<17>();
+  test_multi_step<32>();
+  test_multi_step<33>();
+  test_multi_step<63>();
+  test_multi_step<64>();
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "multiplication.h"
+
+namespace detail {
+/**
+ * the mask for n <= 64 elements, one at a time. 64 bit targets have a fast
+ * 32x32->64 bit multiply which beats the chinese remainder comparison in
+ * products_equal(), so that is only used on 32 bit targets.
+ */
+inline std::uint64_t
+products_equal_scalar(const std::uint32_t* a,
+                      const std::uint32_t* b,
+                      const std::uint32_t* c,
+                      const std::uint32_t* d,
+                      const std::size_t n)
+{
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+#if UINTPTR_MAX > UINT32_MAX
+    using U = std::uint64_t;
+    const bool equal = U{ a[i] } * b[i] == U{ c[i] } * d[i];
+#else
+    const bool equal = products_equal(a[i], b[i], c[i], d[i]);
+#endif
+    mask |= std::uint64_t{ equal } << i;
+  }
+  return mask;
+}
+
+/// the mask for 64 elements, with 32x32->64 bit vector multiplies
+inline std::uint64_t
+products_equal_block(const std::uint32_t* a,
+                     const std::uint32_t* b,
+                     const std::uint32_t* c,
+                     const std::uint32_t* d)
+{
+#if defined(__AVX512F__)
+  // the maskz forms avoid a false -Wmaybe-uninitialized from gcc 12
+  auto load = [](const std::uint32_t* p) {
+    return _mm512_maskz_cvtepu32_epi64(
+      0xFF, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+  };
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < 64; i += 8) {
+    const __m512i ab = _mm512_maskz_mul_epu32(0xFF, load(a + i), load(b + i));
+    const __m512i cd = _mm512_maskz_mul_epu32(0xFF, load(c + i), load(d + i));
+    mask |= std::uint64_t{ _mm512_cmpeq_epi64_mask(ab, cd) } << i;
+  }
+  return mask;
+#elif defined(__AVX2__)
+  auto load = [](const std::uint32_t* p) {
+    return _mm256_cvtepu32_epi64(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+  };
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < 64; i += 4) {
+    const __m256i ab = _mm256_mul_epu32(load(a + i), load(b + i));
+    const __m256i cd = _mm256_mul_epu32(load(c + i), load(d + i));
+    const int bits =
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(ab, cd)));
+    mask |= static_cast<std::uint64_t>(bits) << i;
+  }
+  return mask;
+#else
+  return products_equal_scalar(a, b, c, d, 64);
+#endif
+}
+} // namespace detail
+
+/**
+ * compares a[i]*b[i] with c[i]*d[i] for all i, like products_equal(). this
+ * is vectorized if compiled for AVX2 or AVX-512 (for instance with
+ * -march=native), otherwise the elements are compared one at a time.
+ * @param mask bit i%64 of mask[i/64] is set if the products are equal. it
+ * must have room for a.size() bits. the unused bits of the last word are
+ * cleared.
+ */
+inline void
+products_equal_batch(std::span<const std::uint32_t> a,
+                     std::span<const std::uint32_t> b,
+                     std::span<const std::uint32_t> c,
+                     std::span<const std::uint32_t> d,
+                     std::span<std::uint64_t> mask)
+{
+  const std::size_t n = a.size();
+  assert(b.size() == n && c.size() == n && d.size() == n);
+  assert(mask.size() * 64 >= n);
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    mask[i / 64] = detail::products_equal_block(&a[i], &b[i], &c[i], &d[i]);
+  }
+  if (i < n) {
+    mask[i / 64] =
+      detail::products_equal_scalar(&a[i], &b[i], &c[i], &d[i], n - i);
+  }
+}
@@ -1,6 +1,33 @@
-#include <catch2/benchmark/catch_benchmark.hpp>
-#include <catch2/benchmark/catch_benchmark_all.hpp>
-#include <catch2/catch_test_macros.hpp>
+// sweeps constant and runtime divisors over an input array and prints the
+// time per element as csv or json.
+//
+// every divisor is measured for the same kernels, so constant and runtime
+// divisors can be compared side by side: % by a compile time constant, % by
+// a divisor hidden from the compiler, RuntimeDivisor, and the divisibility
+// tests. the elements are independent, so this measures throughput and the
+// compiler is free to vectorize the constant kernels, like it would in real
+// code.
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+#include "divisibility.h"
+#include "runtime_divisor.h"
 
 template<unsigned M>
 unsigned
@@ -12,649 +39,291 @@ divide(unsigned x)
 template unsigned
 divide<3>(unsigned);
 
-#define STRINGIFY(a) STRINGIFY_IMPL(a)
-#define STRINGIFY_IMPL(a) #a
+namespace {
+
+/// makes the compiler assume value is read and modified
+template<typename T>
+void
+do_not_optimize(T& value)
+{
+  asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+/// makes the compiler assume all memory was modified
+void
+clobber_memory()
+{
+  asm volatile("" : : : "memory");
+}
+
+struct Result
+{
+  std::uint32_t divisor;
+  const char* kernel;
+  std::size_t elements;
+  double ns_per_element;
+  // ticks of the time stamp counter, which runs at a fixed rate and not
+  // necessarily the core clock. negative if not available.
+  double cycles_per_element;
+};
+
+class Sweep
+{
+public:
+  Sweep(const std::size_t elements, const int repetitions)
+    : m_random(elements)
+    , m_input(elements)
+    , m_mask((elements + 63) / 64)
+    , m_repetitions(repetitions)
+  {
+    std::mt19937 rng;
+    for (auto& x : m_random) {
+      x = static_cast<std::uint32_t>(rng());
+    }
+  }
+
+  template<std::uint32_t M>
+  void measure_divisor()
+  {
+    // every third value is a multiple, so the divisibility tests see both
+    for (std::size_t i = 0; i < m_input.size(); ++i) {
+      m_input[i] = i % 3 == 0 ? m_random[i] / M * M : m_random[i];
+    }
+    // the runtime kernels must not see the divisor as a constant
+    volatile std::uint32_t hidden = M;
+    const std::uint32_t d = hidden;
+#if defined(__SIZEOF_INT128__)
+    const RuntimeDivisor divisor(hidden);
+#endif
+
+    measure(M, "constant_mod", [](std::uint32_t x) { return divide<M>(x); });
+    measure(M, "runtime_mod", [d](std::uint32_t x) { return x % d; });
+#if defined(__SIZEOF_INT128__)
+    measure(M, "runtime_divisor_mod", [divisor](std::uint32_t x) {
+      return divisor.mod(x);
+    });
+    measure(M, "runtime_divisor_mulmod", [divisor](std::uint32_t x) {
+      return divisor.mulmod(x, x + 12345);
+    });
+#endif
+    measure(M, "is_divisible", [](std::uint32_t x) {
+      return std::uint32_t{ is_divisible<M>(x) };
+    });
+#if defined(__SIZEOF_INT128__)
+    measure(M, "runtime_divides", [divisor](std::uint32_t x) {
+      return std::uint32_t{ divisor.divides(x) };
+    });
+#endif
+    measure_batch(M, "is_divisible_batch", [this] {
+      is_divisible_batch<M>(m_input, m_mask);
+      return m_mask[0];
+    });
+  }
+
+  const std::vector<Result>& results() const { return m_results; }
+
+private:
+  /// applies kernel to every element, summing the results
+  template<typename Kernel>
+  void measure(const std::uint32_t divisor, const char* name, Kernel kernel)
+  {
+    measure_batch(divisor, name, [this, kernel] {
+      std::uint32_t sum = 0;
+      for (const auto x : m_input) {
+        sum += kernel(x);
+      }
+      return sum;
+    });
+  }
+
+  /// the best of the repetitions of a pass over the input
+  template<typename Pass>
+  void measure_batch(const std::uint32_t divisor, const char* name, Pass pass)
+  {
+    double best_ns = std::numeric_limits<double>::max();
+    double best_cycles = std::numeric_limits<double>::max();
+    for (int repetition = 0; repetition < m_repetitions; ++repetition) {
+      clobber_memory();
+      const auto start = std::chrono::steady_clock::now();
+#ifdef HAVE_RDTSC
+      const auto start_cycles = __rdtsc();
+#endif
+      auto result = pass();
+      do_not_optimize(result);
+#ifdef HAVE_RDTSC
+      best_cycles =
+        std::min(best_cycles, static_cast<double>(__rdtsc() - start_cycles));
+#endif
+      const std::chrono::duration<double, std::nano> elapsed =
+        std::chrono::steady_clock::now() - start;
+      best_ns = std::min(best_ns, elapsed.count());
+    }
+#ifndef HAVE_RDTSC
+    best_cycles = -1.0 * m_input.size();
+#endif
+    const auto n = static_cast<double>(m_input.size());
+    m_results.push_back(
+      { divisor, name, m_input.size(), best_ns / n, best_cycles / n });
+  }
 
-#define IMPLEMENT_BENCHMARK(divisor)                                           \
-  BENCHMARK_ADVANCED("division " STRINGIFY(divisor))(                          \
-    Catch::Benchmark::Chronometer meter)                                       \
-  {                                                                            \
-    meter.measure([](unsigned int i) { return divide<divisor>(i); });          \
-  };
+  std::vector<std::uint32_t> m_random;
+  std::vector<std::uint32_t> m_input;
+  std::vector<std::uint64_t> m_mask;
+  int m_repetitions;
+  std::vector<Result> m_results;
+};
 
-TEST_CASE("Benchmark division", "[!benchmark]")
+template<std::uint32_t... M>
+void
+sweep_list(Sweep& sweep)
 {
-  IMPLEMENT_BENCHMARK(3);
-  IMPLEMENT_BENCHMARK(5);
-  IMPLEMENT_BENCHMARK(7);
-  IMPLEMENT_BENCHMARK(9);
-  IMPLEMENT_BENCHMARK(11);
-  IMPLEMENT_BENCHMARK(13);
-  IMPLEMENT_BENCHMARK(17);
-  IMPLEMENT_BENCHMARK(65535);
-  IMPLEMENT_BENCHMARK(17);
+  (sweep.measure_divisor<M>(), ...);
 }
-TEST_CASE("Benchmark division auto 0-1000", "[!benchmark]")
+
+template<std::uint32_t First, std::uint32_t Step, std::size_t... I>
+void
+sweep_range_impl(Sweep& sweep, std::index_sequence<I...>)
+{
+  sweep_list<static_cast<std::uint32_t>(First + Step * I)...>(sweep);
+}
+
+/// measures First, First + Step, ... Last
+template<std::uint32_t First, std::uint32_t Last, std::uint32_t Step>
+void
+sweep_range(Sweep& sweep)
+{
+  static_assert(First <= Last && (Last - First) % Step == 0);
+  sweep_range_impl<First, Step>(
+    sweep, std::make_index_sequence<(Last - First) / Step + 1>{});
+}
+
+void
+print_csv(const std::vector<Result>& results)
+{
+  std::printf("divisor,kernel,elements,ns_per_element,cycles_per_element\n");
+  for (const auto& r : results) {
+    std::printf("%u,%s,%zu,%.4f,",
+                r.divisor,
+                r.kernel,
+                r.elements,
+                r.ns_per_element);
+    if (r.cycles_per_element >= 0) {
+      std::printf("%.4f", r.cycles_per_element);
+    }
+    std::printf("\n");
+  }
+}
+
+void
+print_json(const std::vector<Result>& results)
 {
-  IMPLEMENT_BENCHMARK(3);
-  IMPLEMENT_BENCHMARK(5);
-  IMPLEMENT_BENCHMARK(7);
-  IMPLEMENT_BENCHMARK(9);
-  IMPLEMENT_BENCHMARK(11);
-  IMPLEMENT_BENCHMARK(13);
-  IMPLEMENT_BENCHMARK(15);
-  IMPLEMENT_BENCHMARK(17);
-  IMPLEMENT_BENCHMARK(19);
-  IMPLEMENT_BENCHMARK(21);
-  IMPLEMENT_BENCHMARK(23);
-  IMPLEMENT_BENCHMARK(25);
-  IMPLEMENT_BENCHMARK(27);
-  IMPLEMENT_BENCHMARK(29);
-  IMPLEMENT_BENCHMARK(31);
-  IMPLEMENT_BENCHMARK(33);
-  IMPLEMENT_BENCHMARK(35);
-  IMPLEMENT_BENCHMARK(37);
-  IMPLEMENT_BENCHMARK(39);
-  IMPLEMENT_BENCHMARK(41);
-  IMPLEMENT_BENCHMARK(43);
-  IMPLEMENT_BENCHMARK(45);
-  IMPLEMENT_BENCHMARK(47);
-  IMPLEMENT_BENCHMARK(49);
-  IMPLEMENT_BENCHMARK(51);
-  IMPLEMENT_BENCHMARK(53);
-  IMPLEMENT_BENCHMARK(55);
-  IMPLEMENT_BENCHMARK(57);
-  IMPLEMENT_BENCHMARK(59);
-  IMPLEMENT_BENCHMARK(61);
-  IMPLEMENT_BENCHMARK(63);
-  IMPLEMENT_BENCHMARK(65);
-  IMPLEMENT_BENCHMARK(67);
-  IMPLEMENT_BENCHMARK(69);
-  IMPLEMENT_BENCHMARK(71);
-  IMPLEMENT_BENCHMARK(73);
-  IMPLEMENT_BENCHMARK(75);
-  IMPLEMENT_BENCHMARK(77);
-  IMPLEMENT_BENCHMARK(79);
-  IMPLEMENT_BENCHMARK(81);
-  IMPLEMENT_BENCHMARK(83);
-  IMPLEMENT_BENCHMARK(85);
-  IMPLEMENT_BENCHMARK(87);
-  IMPLEMENT_BENCHMARK(89);
-  IMPLEMENT_BENCHMARK(91);
-  IMPLEMENT_BENCHMARK(93);
-  IMPLEMENT_BENCHMARK(95);
-  IMPLEMENT_BENCHMARK(97);
-  IMPLEMENT_BENCHMARK(99);
-  IMPLEMENT_BENCHMARK(101);
-  IMPLEMENT_BENCHMARK(103);
-  IMPLEMENT_BENCHMARK(105);
-  IMPLEMENT_BENCHMARK(107);
-  IMPLEMENT_BENCHMARK(109);
-  IMPLEMENT_BENCHMARK(111);
-  IMPLEMENT_BENCHMARK(113);
-  IMPLEMENT_BENCHMARK(115);
-  IMPLEMENT_BENCHMARK(117);
-  IMPLEMENT_BENCHMARK(119);
-  IMPLEMENT_BENCHMARK(121);
-  IMPLEMENT_BENCHMARK(123);
-  IMPLEMENT_BENCHMARK(125);
-  IMPLEMENT_BENCHMARK(127);
-  IMPLEMENT_BENCHMARK(129);
-  IMPLEMENT_BENCHMARK(131);
-  IMPLEMENT_BENCHMARK(133);
-  IMPLEMENT_BENCHMARK(135);
-  IMPLEMENT_BENCHMARK(137);
-  IMPLEMENT_BENCHMARK(139);
-  IMPLEMENT_BENCHMARK(141);
-  IMPLEMENT_BENCHMARK(143);
-  IMPLEMENT_BENCHMARK(145);
-  IMPLEMENT_BENCHMARK(147);
-  IMPLEMENT_BENCHMARK(149);
-  IMPLEMENT_BENCHMARK(151);
-  IMPLEMENT_BENCHMARK(153);
-  IMPLEMENT_BENCHMARK(155);
-  IMPLEMENT_BENCHMARK(157);
-  IMPLEMENT_BENCHMARK(159);
-  IMPLEMENT_BENCHMARK(161);
-  IMPLEMENT_BENCHMARK(163);
-  IMPLEMENT_BENCHMARK(165);
-  IMPLEMENT_BENCHMARK(167);
-  IMPLEMENT_BENCHMARK(169);
-  IMPLEMENT_BENCHMARK(171);
-  IMPLEMENT_BENCHMARK(173);
-  IMPLEMENT_BENCHMARK(175);
-  IMPLEMENT_BENCHMARK(177);
-  IMPLEMENT_BENCHMARK(179);
-  IMPLEMENT_BENCHMARK(181);
-  IMPLEMENT_BENCHMARK(183);
-  IMPLEMENT_BENCHMARK(185);
-  IMPLEMENT_BENCHMARK(187);
-  IMPLEMENT_BENCHMARK(189);
-  IMPLEMENT_BENCHMARK(191);
-  IMPLEMENT_BENCHMARK(193);
-  IMPLEMENT_BENCHMARK(195);
-  IMPLEMENT_BENCHMARK(197);
-  IMPLEMENT_BENCHMARK(199);
-  IMPLEMENT_BENCHMARK(201);
-  IMPLEMENT_BENCHMARK(203);
-  IMPLEMENT_BENCHMARK(205);
-  IMPLEMENT_BENCHMARK(207);
-  IMPLEMENT_BENCHMARK(209);
-  IMPLEMENT_BENCHMARK(211);
-  IMPLEMENT_BENCHMARK(213);
-  IMPLEMENT_BENCHMARK(215);
-  IMPLEMENT_BENCHMARK(217);
-  IMPLEMENT_BENCHMARK(219);
-  IMPLEMENT_BENCHMARK(221);
-  IMPLEMENT_BENCHMARK(223);
-  IMPLEMENT_BENCHMARK(225);
-  IMPLEMENT_BENCHMARK(227);
-  IMPLEMENT_BENCHMARK(229);
-  IMPLEMENT_BENCHMARK(231);
-  IMPLEMENT_BENCHMARK(233);
-  IMPLEMENT_BENCHMARK(235);
-  IMPLEMENT_BENCHMARK(237);
-  IMPLEMENT_BENCHMARK(239);
-  IMPLEMENT_BENCHMARK(241);
-  IMPLEMENT_BENCHMARK(243);
-  IMPLEMENT_BENCHMARK(245);
-  IMPLEMENT_BENCHMARK(247);
-  IMPLEMENT_BENCHMARK(249);
-  IMPLEMENT_BENCHMARK(251);
-  IMPLEMENT_BENCHMARK(253);
-  IMPLEMENT_BENCHMARK(255);
-  IMPLEMENT_BENCHMARK(257);
-  IMPLEMENT_BENCHMARK(259);
-  IMPLEMENT_BENCHMARK(261);
-  IMPLEMENT_BENCHMARK(263);
-  IMPLEMENT_BENCHMARK(265);
-  IMPLEMENT_BENCHMARK(267);
-  IMPLEMENT_BENCHMARK(269);
-  IMPLEMENT_BENCHMARK(271);
-  IMPLEMENT_BENCHMARK(273);
-  IMPLEMENT_BENCHMARK(275);
-  IMPLEMENT_BENCHMARK(277);
-  IMPLEMENT_BENCHMARK(279);
-  IMPLEMENT_BENCHMARK(281);
-  IMPLEMENT_BENCHMARK(283);
-  IMPLEMENT_BENCHMARK(285);
-  IMPLEMENT_BENCHMARK(287);
-  IMPLEMENT_BENCHMARK(289);
-  IMPLEMENT_BENCHMARK(291);
-  IMPLEMENT_BENCHMARK(293);
-  IMPLEMENT_BENCHMARK(295);
-  IMPLEMENT_BENCHMARK(297);
-  IMPLEMENT_BENCHMARK(299);
-  IMPLEMENT_BENCHMARK(301);
-  IMPLEMENT_BENCHMARK(303);
-  IMPLEMENT_BENCHMARK(305);
-  IMPLEMENT_BENCHMARK(307);
-  IMPLEMENT_BENCHMARK(309);
-  IMPLEMENT_BENCHMARK(311);
-  IMPLEMENT_BENCHMARK(313);
-  IMPLEMENT_BENCHMARK(315);
-  IMPLEMENT_BENCHMARK(317);
-  IMPLEMENT_BENCHMARK(319);
-  IMPLEMENT_BENCHMARK(321);
-  IMPLEMENT_BENCHMARK(323);
-  IMPLEMENT_BENCHMARK(325);
-  IMPLEMENT_BENCHMARK(327);
-  IMPLEMENT_BENCHMARK(329);
-  IMPLEMENT_BENCHMARK(331);
-  IMPLEMENT_BENCHMARK(333);
-  IMPLEMENT_BENCHMARK(335);
-  IMPLEMENT_BENCHMARK(337);
-  IMPLEMENT_BENCHMARK(339);
-  IMPLEMENT_BENCHMARK(341);
-  IMPLEMENT_BENCHMARK(343);
-  IMPLEMENT_BENCHMARK(345);
-  IMPLEMENT_BENCHMARK(347);
-  IMPLEMENT_BENCHMARK(349);
-  IMPLEMENT_BENCHMARK(351);
-  IMPLEMENT_BENCHMARK(353);
-  IMPLEMENT_BENCHMARK(355);
-  IMPLEMENT_BENCHMARK(357);
-  IMPLEMENT_BENCHMARK(359);
-  IMPLEMENT_BENCHMARK(361);
-  IMPLEMENT_BENCHMARK(363);
-  IMPLEMENT_BENCHMARK(365);
-  IMPLEMENT_BENCHMARK(367);
-  IMPLEMENT_BENCHMARK(369);
-  IMPLEMENT_BENCHMARK(371);
-  IMPLEMENT_BENCHMARK(373);
-  IMPLEMENT_BENCHMARK(375);
-  IMPLEMENT_BENCHMARK(377);
-  IMPLEMENT_BENCHMARK(379);
-  IMPLEMENT_BENCHMARK(381);
-  IMPLEMENT_BENCHMARK(383);
-  IMPLEMENT_BENCHMARK(385);
-  IMPLEMENT_BENCHMARK(387);
-  IMPLEMENT_BENCHMARK(389);
-  IMPLEMENT_BENCHMARK(391);
-  IMPLEMENT_BENCHMARK(393);
-  IMPLEMENT_BENCHMARK(395);
-  IMPLEMENT_BENCHMARK(397);
-  IMPLEMENT_BENCHMARK(399);
-  IMPLEMENT_BENCHMARK(401);
-  IMPLEMENT_BENCHMARK(403);
-  IMPLEMENT_BENCHMARK(405);
-  IMPLEMENT_BENCHMARK(407);
-  IMPLEMENT_BENCHMARK(409);
-  IMPLEMENT_BENCHMARK(411);
-  IMPLEMENT_BENCHMARK(413);
-  IMPLEMENT_BENCHMARK(415);
-  IMPLEMENT_BENCHMARK(417);
-  IMPLEMENT_BENCHMARK(419);
-  IMPLEMENT_BENCHMARK(421);
-  IMPLEMENT_BENCHMARK(423);
-  IMPLEMENT_BENCHMARK(425);
-  IMPLEMENT_BENCHMARK(427);
-  IMPLEMENT_BENCHMARK(429);
-  IMPLEMENT_BENCHMARK(431);
-  IMPLEMENT_BENCHMARK(433);
-  IMPLEMENT_BENCHMARK(435);
-  IMPLEMENT_BENCHMARK(437);
-  IMPLEMENT_BENCHMARK(439);
-  IMPLEMENT_BENCHMARK(441);
-  IMPLEMENT_BENCHMARK(443);
-  IMPLEMENT_BENCHMARK(445);
-  IMPLEMENT_BENCHMARK(447);
-  IMPLEMENT_BENCHMARK(449);
-  IMPLEMENT_BENCHMARK(451);
-  IMPLEMENT_BENCHMARK(453);
-  IMPLEMENT_BENCHMARK(455);
-  IMPLEMENT_BENCHMARK(457);
-  IMPLEMENT_BENCHMARK(459);
-  IMPLEMENT_BENCHMARK(461);
-  IMPLEMENT_BENCHMARK(463);
-  IMPLEMENT_BENCHMARK(465);
-  IMPLEMENT_BENCHMARK(467);
-  IMPLEMENT_BENCHMARK(469);
-  IMPLEMENT_BENCHMARK(471);
-  IMPLEMENT_BENCHMARK(473);
-  IMPLEMENT_BENCHMARK(475);
-  IMPLEMENT_BENCHMARK(477);
-  IMPLEMENT_BENCHMARK(479);
-  IMPLEMENT_BENCHMARK(481);
-  IMPLEMENT_BENCHMARK(483);
-  IMPLEMENT_BENCHMARK(485);
-  IMPLEMENT_BENCHMARK(487);
-  IMPLEMENT_BENCHMARK(489);
-  IMPLEMENT_BENCHMARK(491);
-  IMPLEMENT_BENCHMARK(493);
-  IMPLEMENT_BENCHMARK(495);
-  IMPLEMENT_BENCHMARK(497);
-  IMPLEMENT_BENCHMARK(499);
-  IMPLEMENT_BENCHMARK(501);
-  IMPLEMENT_BENCHMARK(503);
-  IMPLEMENT_BENCHMARK(505);
-  IMPLEMENT_BENCHMARK(507);
-  IMPLEMENT_BENCHMARK(509);
-  IMPLEMENT_BENCHMARK(511);
-  IMPLEMENT_BENCHMARK(513);
-  IMPLEMENT_BENCHMARK(515);
-  IMPLEMENT_BENCHMARK(517);
-  IMPLEMENT_BENCHMARK(519);
-  IMPLEMENT_BENCHMARK(521);
-  IMPLEMENT_BENCHMARK(523);
-  IMPLEMENT_BENCHMARK(525);
-  IMPLEMENT_BENCHMARK(527);
-  IMPLEMENT_BENCHMARK(529);
-  IMPLEMENT_BENCHMARK(531);
-  IMPLEMENT_BENCHMARK(533);
-  IMPLEMENT_BENCHMARK(535);
-  IMPLEMENT_BENCHMARK(537);
-  IMPLEMENT_BENCHMARK(539);
-  IMPLEMENT_BENCHMARK(541);
-  IMPLEMENT_BENCHMARK(543);
-  IMPLEMENT_BENCHMARK(545);
-  IMPLEMENT_BENCHMARK(547);
-  IMPLEMENT_BENCHMARK(549);
-  IMPLEMENT_BENCHMARK(551);
-  IMPLEMENT_BENCHMARK(553);
-  IMPLEMENT_BENCHMARK(555);
-  IMPLEMENT_BENCHMARK(557);
-  IMPLEMENT_BENCHMARK(559);
-  IMPLEMENT_BENCHMARK(561);
-  IMPLEMENT_BENCHMARK(563);
-  IMPLEMENT_BENCHMARK(565);
-  IMPLEMENT_BENCHMARK(567);
-  IMPLEMENT_BENCHMARK(569);
-  IMPLEMENT_BENCHMARK(571);
-  IMPLEMENT_BENCHMARK(573);
-  IMPLEMENT_BENCHMARK(575);
-  IMPLEMENT_BENCHMARK(577);
-  IMPLEMENT_BENCHMARK(579);
-  IMPLEMENT_BENCHMARK(581);
-  IMPLEMENT_BENCHMARK(583);
-  IMPLEMENT_BENCHMARK(585);
-  IMPLEMENT_BENCHMARK(587);
-  IMPLEMENT_BENCHMARK(589);
-  IMPLEMENT_BENCHMARK(591);
-  IMPLEMENT_BENCHMARK(593);
-  IMPLEMENT_BENCHMARK(595);
-  IMPLEMENT_BENCHMARK(597);
-  IMPLEMENT_BENCHMARK(599);
-  IMPLEMENT_BENCHMARK(601);
-  IMPLEMENT_BENCHMARK(603);
-  IMPLEMENT_BENCHMARK(605);
-  IMPLEMENT_BENCHMARK(607);
-  IMPLEMENT_BENCHMARK(609);
-  IMPLEMENT_BENCHMARK(611);
-  IMPLEMENT_BENCHMARK(613);
-  IMPLEMENT_BENCHMARK(615);
-  IMPLEMENT_BENCHMARK(617);
-  IMPLEMENT_BENCHMARK(619);
-  IMPLEMENT_BENCHMARK(621);
-  IMPLEMENT_BENCHMARK(623);
-  IMPLEMENT_BENCHMARK(625);
-  IMPLEMENT_BENCHMARK(627);
-  IMPLEMENT_BENCHMARK(629);
-  IMPLEMENT_BENCHMARK(631);
-  IMPLEMENT_BENCHMARK(633);
-  IMPLEMENT_BENCHMARK(635);
-  IMPLEMENT_BENCHMARK(637);
-  IMPLEMENT_BENCHMARK(639);
-  IMPLEMENT_BENCHMARK(641);
-  IMPLEMENT_BENCHMARK(643);
-  IMPLEMENT_BENCHMARK(645);
-  IMPLEMENT_BENCHMARK(647);
-  IMPLEMENT_BENCHMARK(649);
-  IMPLEMENT_BENCHMARK(651);
-  IMPLEMENT_BENCHMARK(653);
-  IMPLEMENT_BENCHMARK(655);
-  IMPLEMENT_BENCHMARK(657);
-  IMPLEMENT_BENCHMARK(659);
-  IMPLEMENT_BENCHMARK(661);
-  IMPLEMENT_BENCHMARK(663);
-  IMPLEMENT_BENCHMARK(665);
-  IMPLEMENT_BENCHMARK(667);
-  IMPLEMENT_BENCHMARK(669);
-  IMPLEMENT_BENCHMARK(671);
-  IMPLEMENT_BENCHMARK(673);
-  IMPLEMENT_BENCHMARK(675);
-  IMPLEMENT_BENCHMARK(677);
-  IMPLEMENT_BENCHMARK(679);
-  IMPLEMENT_BENCHMARK(681);
-  IMPLEMENT_BENCHMARK(683);
-  IMPLEMENT_BENCHMARK(685);
-  IMPLEMENT_BENCHMARK(687);
-  IMPLEMENT_BENCHMARK(689);
-  IMPLEMENT_BENCHMARK(691);
-  IMPLEMENT_BENCHMARK(693);
-  IMPLEMENT_BENCHMARK(695);
-  IMPLEMENT_BENCHMARK(697);
-  IMPLEMENT_BENCHMARK(699);
-  IMPLEMENT_BENCHMARK(701);
-  IMPLEMENT_BENCHMARK(703);
-  IMPLEMENT_BENCHMARK(705);
-  IMPLEMENT_BENCHMARK(707);
-  IMPLEMENT_BENCHMARK(709);
-  IMPLEMENT_BENCHMARK(711);
-  IMPLEMENT_BENCHMARK(713);
-  IMPLEMENT_BENCHMARK(715);
-  IMPLEMENT_BENCHMARK(717);
-  IMPLEMENT_BENCHMARK(719);
-  IMPLEMENT_BENCHMARK(721);
-  IMPLEMENT_BENCHMARK(723);
-  IMPLEMENT_BENCHMARK(725);
-  IMPLEMENT_BENCHMARK(727);
-  IMPLEMENT_BENCHMARK(729);
-  IMPLEMENT_BENCHMARK(731);
-  IMPLEMENT_BENCHMARK(733);
-  IMPLEMENT_BENCHMARK(735);
-  IMPLEMENT_BENCHMARK(737);
-  IMPLEMENT_BENCHMARK(739);
-  IMPLEMENT_BENCHMARK(741);
-  IMPLEMENT_BENCHMARK(743);
-  IMPLEMENT_BENCHMARK(745);
-  IMPLEMENT_BENCHMARK(747);
-  IMPLEMENT_BENCHMARK(749);
-  IMPLEMENT_BENCHMARK(751);
-  IMPLEMENT_BENCHMARK(753);
-  IMPLEMENT_BENCHMARK(755);
-  IMPLEMENT_BENCHMARK(757);
-  IMPLEMENT_BENCHMARK(759);
-  IMPLEMENT_BENCHMARK(761);
-  IMPLEMENT_BENCHMARK(763);
-  IMPLEMENT_BENCHMARK(765);
-  IMPLEMENT_BENCHMARK(767);
-  IMPLEMENT_BENCHMARK(769);
-  IMPLEMENT_BENCHMARK(771);
-  IMPLEMENT_BENCHMARK(773);
-  IMPLEMENT_BENCHMARK(775);
-  IMPLEMENT_BENCHMARK(777);
-  IMPLEMENT_BENCHMARK(779);
-  IMPLEMENT_BENCHMARK(781);
-  IMPLEMENT_BENCHMARK(783);
-  IMPLEMENT_BENCHMARK(785);
-  IMPLEMENT_BENCHMARK(787);
-  IMPLEMENT_BENCHMARK(789);
-  IMPLEMENT_BENCHMARK(791);
-  IMPLEMENT_BENCHMARK(793);
-  IMPLEMENT_BENCHMARK(795);
-  IMPLEMENT_BENCHMARK(797);
-  IMPLEMENT_BENCHMARK(799);
-  IMPLEMENT_BENCHMARK(801);
-  IMPLEMENT_BENCHMARK(803);
-  IMPLEMENT_BENCHMARK(805);
-  IMPLEMENT_BENCHMARK(807);
-  IMPLEMENT_BENCHMARK(809);
-  IMPLEMENT_BENCHMARK(811);
-  IMPLEMENT_BENCHMARK(813);
-  IMPLEMENT_BENCHMARK(815);
-  IMPLEMENT_BENCHMARK(817);
-  IMPLEMENT_BENCHMARK(819);
-  IMPLEMENT_BENCHMARK(821);
-  IMPLEMENT_BENCHMARK(823);
-  IMPLEMENT_BENCHMARK(825);
-  IMPLEMENT_BENCHMARK(827);
-  IMPLEMENT_BENCHMARK(829);
-  IMPLEMENT_BENCHMARK(831);
-  IMPLEMENT_BENCHMARK(833);
-  IMPLEMENT_BENCHMARK(835);
-  IMPLEMENT_BENCHMARK(837);
-  IMPLEMENT_BENCHMARK(839);
-  IMPLEMENT_BENCHMARK(841);
-  IMPLEMENT_BENCHMARK(843);
-  IMPLEMENT_BENCHMARK(845);
-  IMPLEMENT_BENCHMARK(847);
-  IMPLEMENT_BENCHMARK(849);
-  IMPLEMENT_BENCHMARK(851);
-  IMPLEMENT_BENCHMARK(853);
-  IMPLEMENT_BENCHMARK(855);
-  IMPLEMENT_BENCHMARK(857);
-  IMPLEMENT_BENCHMARK(859);
-  IMPLEMENT_BENCHMARK(861);
-  IMPLEMENT_BENCHMARK(863);
-  IMPLEMENT_BENCHMARK(865);
-  IMPLEMENT_BENCHMARK(867);
-  IMPLEMENT_BENCHMARK(869);
-  IMPLEMENT_BENCHMARK(871);
-  IMPLEMENT_BENCHMARK(873);
-  IMPLEMENT_BENCHMARK(875);
-  IMPLEMENT_BENCHMARK(877);
-  IMPLEMENT_BENCHMARK(879);
-  IMPLEMENT_BENCHMARK(881);
-  IMPLEMENT_BENCHMARK(883);
-  IMPLEMENT_BENCHMARK(885);
-  IMPLEMENT_BENCHMARK(887);
-  IMPLEMENT_BENCHMARK(889);
-  IMPLEMENT_BENCHMARK(891);
-  IMPLEMENT_BENCHMARK(893);
-  IMPLEMENT_BENCHMARK(895);
-  IMPLEMENT_BENCHMARK(897);
-  IMPLEMENT_BENCHMARK(899);
-  IMPLEMENT_BENCHMARK(901);
-  IMPLEMENT_BENCHMARK(903);
-  IMPLEMENT_BENCHMARK(905);
-  IMPLEMENT_BENCHMARK(907);
-  IMPLEMENT_BENCHMARK(909);
-  IMPLEMENT_BENCHMARK(911);
-  IMPLEMENT_BENCHMARK(913);
-  IMPLEMENT_BENCHMARK(915);
-  IMPLEMENT_BENCHMARK(917);
-  IMPLEMENT_BENCHMARK(919);
-  IMPLEMENT_BENCHMARK(921);
-  IMPLEMENT_BENCHMARK(923);
-  IMPLEMENT_BENCHMARK(925);
-  IMPLEMENT_BENCHMARK(927);
-  IMPLEMENT_BENCHMARK(929);
-  IMPLEMENT_BENCHMARK(931);
-  IMPLEMENT_BENCHMARK(933);
-  IMPLEMENT_BENCHMARK(935);
-  IMPLEMENT_BENCHMARK(937);
-  IMPLEMENT_BENCHMARK(939);
-  IMPLEMENT_BENCHMARK(941);
-  IMPLEMENT_BENCHMARK(943);
-  IMPLEMENT_BENCHMARK(945);
-  IMPLEMENT_BENCHMARK(947);
-  IMPLEMENT_BENCHMARK(949);
-  IMPLEMENT_BENCHMARK(951);
-  IMPLEMENT_BENCHMARK(953);
-  IMPLEMENT_BENCHMARK(955);
-  IMPLEMENT_BENCHMARK(957);
-  IMPLEMENT_BENCHMARK(959);
-  IMPLEMENT_BENCHMARK(961);
-  IMPLEMENT_BENCHMARK(963);
-  IMPLEMENT_BENCHMARK(965);
-  IMPLEMENT_BENCHMARK(967);
-  IMPLEMENT_BENCHMARK(969);
-  IMPLEMENT_BENCHMARK(971);
-  IMPLEMENT_BENCHMARK(973);
-  IMPLEMENT_BENCHMARK(975);
-  IMPLEMENT_BENCHMARK(977);
-  IMPLEMENT_BENCHMARK(979);
-  IMPLEMENT_BENCHMARK(981);
-  IMPLEMENT_BENCHMARK(983);
-  IMPLEMENT_BENCHMARK(985);
-  IMPLEMENT_BENCHMARK(987);
-  IMPLEMENT_BENCHMARK(989);
-  IMPLEMENT_BENCHMARK(991);
-  IMPLEMENT_BENCHMARK(993);
-  IMPLEMENT_BENCHMARK(995);
-  IMPLEMENT_BENCHMARK(997);
-  IMPLEMENT_BENCHMARK(999);
+  std::printf("[\n");
+  for (std::size_t i = 0; i < results.size(); ++i) {
+    const auto& r = results[i];
+    std::printf("  {\"divisor\": %u, \"kernel\": \"%s\", \"elements\": %zu, "
+                "\"ns_per_element\": %.4f, \"cycles_per_element\": ",
+                r.divisor,
+                r.kernel,
+                r.elements,
+                r.ns_per_element);
+    if (r.cycles_per_element >= 0) {
+      std::printf("%.4f}", r.cycles_per_element);
+    } else {
+      std::printf("null}");
+    }
+    std::printf("%s\n", i + 1 < results.size() ? "," : "");
+  }
+  std::printf("]\n");
 }
 
-TEST_CASE("Benchmark division auto close below 2**16", "[!benchmark]")
+template<typename T>
+T
+parse(const char* arg)
 {
-  IMPLEMENT_BENCHMARK(65301);
-  IMPLEMENT_BENCHMARK(65303);
-  IMPLEMENT_BENCHMARK(65305);
-  IMPLEMENT_BENCHMARK(65307);
-  IMPLEMENT_BENCHMARK(65309);
-  IMPLEMENT_BENCHMARK(65311);
-  IMPLEMENT_BENCHMARK(65313);
-  IMPLEMENT_BENCHMARK(65315);
-  IMPLEMENT_BENCHMARK(65317);
-  IMPLEMENT_BENCHMARK(65319);
-  IMPLEMENT_BENCHMARK(65321);
-  IMPLEMENT_BENCHMARK(65323);
-  IMPLEMENT_BENCHMARK(65325);
-  IMPLEMENT_BENCHMARK(65327);
-  IMPLEMENT_BENCHMARK(65329);
-  IMPLEMENT_BENCHMARK(65331);
-  IMPLEMENT_BENCHMARK(65333);
-  IMPLEMENT_BENCHMARK(65335);
-  IMPLEMENT_BENCHMARK(65337);
-  IMPLEMENT_BENCHMARK(65339);
-  IMPLEMENT_BENCHMARK(65341);
-  IMPLEMENT_BENCHMARK(65343);
-  IMPLEMENT_BENCHMARK(65345);
-  IMPLEMENT_BENCHMARK(65347);
-  IMPLEMENT_BENCHMARK(65349);
-  IMPLEMENT_BENCHMARK(65351);
-  IMPLEMENT_BENCHMARK(65353);
-  IMPLEMENT_BENCHMARK(65355);
-  IMPLEMENT_BENCHMARK(65357);
-  IMPLEMENT_BENCHMARK(65359);
-  IMPLEMENT_BENCHMARK(65361);
-  IMPLEMENT_BENCHMARK(65363);
-  IMPLEMENT_BENCHMARK(65365);
-  IMPLEMENT_BENCHMARK(65367);
-  IMPLEMENT_BENCHMARK(65369);
-  IMPLEMENT_BENCHMARK(65371);
-  IMPLEMENT_BENCHMARK(65373);
-  IMPLEMENT_BENCHMARK(65375);
-  IMPLEMENT_BENCHMARK(65377);
-  IMPLEMENT_BENCHMARK(65379);
-  IMPLEMENT_BENCHMARK(65381);
-  IMPLEMENT_BENCHMARK(65383);
-  IMPLEMENT_BENCHMARK(65385);
-  IMPLEMENT_BENCHMARK(65387);
-  IMPLEMENT_BENCHMARK(65389);
-  IMPLEMENT_BENCHMARK(65391);
-  IMPLEMENT_BENCHMARK(65393);
-  IMPLEMENT_BENCHMARK(65395);
-  IMPLEMENT_BENCHMARK(65397);
-  IMPLEMENT_BENCHMARK(65399);
-  IMPLEMENT_BENCHMARK(65401);
-  IMPLEMENT_BENCHMARK(65403);
-  IMPLEMENT_BENCHMARK(65405);
-  IMPLEMENT_BENCHMARK(65407);
-  IMPLEMENT_BENCHMARK(65409);
-  IMPLEMENT_BENCHMARK(65411);
-  IMPLEMENT_BENCHMARK(65413);
-  IMPLEMENT_BENCHMARK(65415);
-  IMPLEMENT_BENCHMARK(65417);
-  IMPLEMENT_BENCHMARK(65419);
-  IMPLEMENT_BENCHMARK(65421);
-  IMPLEMENT_BENCHMARK(65423);
-  IMPLEMENT_BENCHMARK(65425);
-  IMPLEMENT_BENCHMARK(65427);
-  IMPLEMENT_BENCHMARK(65429);
-  IMPLEMENT_BENCHMARK(65431);
-  IMPLEMENT_BENCHMARK(65433);
-  IMPLEMENT_BENCHMARK(65435);
-  IMPLEMENT_BENCHMARK(65437);
-  IMPLEMENT_BENCHMARK(65439);
-  IMPLEMENT_BENCHMARK(65441);
-  IMPLEMENT_BENCHMARK(65443);
-  IMPLEMENT_BENCHMARK(65445);
-  IMPLEMENT_BENCHMARK(65447);
-  IMPLEMENT_BENCHMARK(65449);
-  IMPLEMENT_BENCHMARK(65451);
-  IMPLEMENT_BENCHMARK(65453);
-  IMPLEMENT_BENCHMARK(65455);
-  IMPLEMENT_BENCHMARK(65457);
-  IMPLEMENT_BENCHMARK(65459);
-  IMPLEMENT_BENCHMARK(65461);
-  IMPLEMENT_BENCHMARK(65463);
-  IMPLEMENT_BENCHMARK(65465);
-  IMPLEMENT_BENCHMARK(65467);
-  IMPLEMENT_BENCHMARK(65469);
-  IMPLEMENT_BENCHMARK(65471);
-  IMPLEMENT_BENCHMARK(65473);
-  IMPLEMENT_BENCHMARK(65475);
-  IMPLEMENT_BENCHMARK(65477);
-  IMPLEMENT_BENCHMARK(65479);
-  IMPLEMENT_BENCHMARK(65481);
-  IMPLEMENT_BENCHMARK(65483);
-  IMPLEMENT_BENCHMARK(65485);
-  IMPLEMENT_BENCHMARK(65487);
-  IMPLEMENT_BENCHMARK(65489);
-  IMPLEMENT_BENCHMARK(65491);
-  IMPLEMENT_BENCHMARK(65493);
-  IMPLEMENT_BENCHMARK(65495);
-  IMPLEMENT_BENCHMARK(65497);
-  IMPLEMENT_BENCHMARK(65499);
-  IMPLEMENT_BENCHMARK(65501);
-  IMPLEMENT_BENCHMARK(65503);
-  IMPLEMENT_BENCHMARK(65505);
-  IMPLEMENT_BENCHMARK(65507);
-  IMPLEMENT_BENCHMARK(65509);
-  IMPLEMENT_BENCHMARK(65511);
-  IMPLEMENT_BENCHMARK(65513);
-  IMPLEMENT_BENCHMARK(65515);
-  IMPLEMENT_BENCHMARK(65517);
-  IMPLEMENT_BENCHMARK(65519);
-  IMPLEMENT_BENCHMARK(65521);
-  IMPLEMENT_BENCHMARK(65523);
-  IMPLEMENT_BENCHMARK(65525);
-  IMPLEMENT_BENCHMARK(65527);
-  IMPLEMENT_BENCHMARK(65529);
-  IMPLEMENT_BENCHMARK(65531);
-  IMPLEMENT_BENCHMARK(65533);
-  IMPLEMENT_BENCHMARK(65535);
+  std::stringstream x(arg);
+  T value;
+  if (!(x >> value) || !x.eof()) {
+    std::fprintf(stderr, "failed parse of %s\n", arg);
+    std::exit(EXIT_FAILURE);
+  }
+  return value;
+}
+
+void
+usage(const char* argv0)
+{
+  std::fprintf(
+    stderr,
+    "usage: %s [-r range] [-n elements] [-R repetitions] [-f format]\n"
+    "  -r range        selected (default), small (odd 3-999),\n"
+    "                  below16 (odd 65301-65535), large or all,\n"
+    "                  which is small, below16 and large\n"
+    "  -n elements     the input size, default 4096\n"
+    "  -R repetitions  the best of this many passes is kept, default 100\n"
+    "  -f format       csv (default) or json\n",
+    argv0);
+  std::exit(EXIT_FAILURE);
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string range = "selected";
+  std::size_t elements = 4096;
+  int repetitions = 100;
+  bool json = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-r" && i + 1 < argc) {
+      range = argv[++i];
+    } else if (arg == "-n" && i + 1 < argc) {
+      elements = parse<std::size_t>(argv[++i]);
+    } else if (arg == "-R" && i + 1 < argc) {
+      repetitions = parse<int>(argv[++i]);
+    } else if (arg == "-f" && i + 1 < argc) {
+      const std::string f = argv[++i];
+      if (f != "csv" && f != "json") {
+        usage(argv[0]);
+      }
+      json = f == "json";
+    } else {
+      usage(argv[0]);
+    }
+  }
+  if (elements == 0 || repetitions < 1) {
+    usage(argv[0]);
+  }
+
+  Sweep sweep(elements, repetitions);
+  const bool all = range == "all";
+  bool known = all;
+  // the selected divisors are all in small and below16, so all skips them
+  // rather than measuring them twice
+  if (range == "selected") {
+    sweep_list<3, 5, 7, 9, 11, 13, 17, 65481, 65483, 65485, 65535>(sweep);
+    known = true;
+  }
+  if (all || range == "small") {
+    sweep_range<3, 999, 2>(sweep);
+    known = true;
+  }
+  if (all || range == "below16") {
+    sweep_range<65301, 65535, 2>(sweep);
+    known = true;
+  }
+  if (all || range == "large") {
+    sweep_list<65536, 1U << 31, 4294967291U, 4294967295U>(sweep);
+    known = true;
+  }
+  if (!known) {
+    usage(argv[0]);
+  }
+
+  if (json) {
+    print_json(sweep.results());
+  } else {
+    print_csv(sweep.results());
+  }
+  return EXIT_SUCCESS;
 }
@@ -1,8 +1,16 @@
 #include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
 #include <random>
+#include <string>
+#include <vector>
 
+#include "batch_products_equal.h"
 #include "multiplication.h"
+#include "products_equal_counters.h"
 
 namespace {
 bool
@@ -44,3 +52,188 @@ TEST_CASE("Benchmark equality", "[!benchmark]")
     });
   };
 }
+
+TEST_CASE("Benchmark batch equality", "[!benchmark]")
+{
+  // large enough to measure throughput but small enough to stay in cache,
+  // a quarter of the products are equal
+  constexpr std::size_t n = 1 << 14;
+  std::vector<std::uint32_t> a(n), b(n), c(n), d(n);
+  std::mt19937 rng;
+  for (std::size_t i = 0; i < n; ++i) {
+    a[i] = rng();
+    b[i] = rng();
+    c[i] = i % 4 == 0 ? b[i] : rng();
+    d[i] = i % 4 == 0 ? a[i] : rng();
+  }
+  std::vector<std::uint64_t> mask(n / 64);
+
+  BENCHMARK("64 bit multiplication, 2**14 elements")
+  {
+    for (std::size_t i = 0; i < n; i += 64) {
+      std::uint64_t m = 0;
+      for (std::size_t j = 0; j < 64; ++j) {
+        m |= std::uint64_t{ reference_products_equal(
+               a[i + j], b[i + j], c[i + j], d[i + j]) }
+             << j;
+      }
+      mask[i / 64] = m;
+    }
+    return mask[0];
+  };
+  BENCHMARK("chinese remainder, 2**14 elements")
+  {
+    for (std::size_t i = 0; i < n; i += 64) {
+      std::uint64_t m = 0;
+      for (std::size_t j = 0; j < 64; ++j) {
+        m |= std::uint64_t{ products_equal(
+               a[i + j], b[i + j], c[i + j], d[i + j]) }
+             << j;
+      }
+      mask[i / 64] = m;
+    }
+    return mask[0];
+  };
+  BENCHMARK("batch, 2**14 elements")
+  {
+    products_equal_batch(a, b, c, d, mask);
+    return mask[0];
+  };
+}
+
+namespace {
+/// inputs for the n term benchmarks, half of them with equal products
+template<std::size_t K>
+std::vector<std::array<std::uint64_t, K>>
+make_factors(const std::size_t n)
+{
+  std::mt19937_64 rng;
+  std::vector<std::array<std::uint64_t, K>> ret(n);
+  for (std::size_t i = 0; i < n; i += 2) {
+    for (auto& x : ret[i]) {
+      x = rng();
+    }
+    ret[i + 1] = ret[i];
+    if (i % 4 == 0) {
+      ret[i + 1][0] ^= 1;
+    }
+  }
+  return ret;
+}
+
+template<std::size_t K>
+void
+benchmark_n_term_products()
+{
+  constexpr std::size_t n = 1 << 12;
+  const auto factors = make_factors<K>(n);
+  const auto name = std::to_string(K) + " factors, 2**11 comparisons";
+
+  BENCHMARK("chinese remainder, " + name)
+  {
+    unsigned count = 0;
+    for (std::size_t i = 0; i < n; i += 2) {
+      count += products_equal_crt(factors[i], factors[i + 1]);
+    }
+    return count;
+  };
+#if defined(__SIZEOF_INT128__)
+  BENCHMARK("128 bit multiplication, " + name)
+  {
+    unsigned count = 0;
+    for (std::size_t i = 0; i < n; i += 2) {
+      count += products_equal_int128(factors[i], factors[i + 1]);
+    }
+    return count;
+  };
+#endif
+}
+} // namespace
+
+TEST_CASE("Benchmark 64 bit equality", "[!benchmark]")
+{
+  benchmark_n_term_products<2>();
+  benchmark_n_term_products<3>();
+  benchmark_n_term_products<4>();
+  benchmark_n_term_products<8>();
+}
+
+namespace {
+struct Workload
+{
+  std::vector<std::uint32_t> a, b, c, d;
+};
+
+/// products made from the same 16 bit pieces are equal with the given
+/// probability, the others are random
+Workload
+make_workload(const std::size_t n, const double equal_fraction)
+{
+  std::mt19937 rng;
+  std::bernoulli_distribution equal(equal_fraction);
+  Workload w;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (equal(rng)) {
+      const std::uint32_t x[4] = { static_cast<std::uint32_t>(rng() >> 16),
+                                   static_cast<std::uint32_t>(rng() >> 16),
+                                   static_cast<std::uint32_t>(rng() >> 16),
+                                   static_cast<std::uint32_t>(rng() >> 16) };
+      w.a.push_back(x[0] * x[1]);
+      w.b.push_back(x[2] * x[3]);
+      w.c.push_back(x[0] * x[2]);
+      w.d.push_back(x[1] * x[3]);
+    } else {
+      w.a.push_back(static_cast<std::uint32_t>(rng()));
+      w.b.push_back(static_cast<std::uint32_t>(rng()));
+      w.c.push_back(static_cast<std::uint32_t>(rng()));
+      w.d.push_back(static_cast<std::uint32_t>(rng()));
+    }
+  }
+  return w;
+}
+
+void
+benchmark_workload(const std::string& name, const double equal_fraction)
+{
+  constexpr std::size_t n = 1 << 12;
+  const auto w = make_workload(n, equal_fraction);
+
+  ProductsEqualCounters counters;
+  for (std::size_t i = 0; i < n; ++i) {
+    counters(w.a[i], w.b[i], w.c[i], w.d[i]);
+  }
+  std::cout << name << ": decided by stage";
+  for (std::size_t stage = 0; stage < products_equal_stages; ++stage) {
+    std::cout << ' ' << stage << ": " << counters.count(stage);
+  }
+  std::cout << ", equal: " << counters.count(products_equal_stages)
+            << ", past the first stage: " << counters.past_first_stage()
+            << '\n';
+
+  // the loops use the runtime size, a constant trip count lets the compiler
+  // vectorize both variants into the same code
+  BENCHMARK("chinese remainder, " + name)
+  {
+    unsigned count = 0;
+    for (std::size_t i = 0; i < w.a.size(); ++i) {
+      count += products_equal(w.a[i], w.b[i], w.c[i], w.d[i]);
+    }
+    return count;
+  };
+  BENCHMARK("branchless, " + name)
+  {
+    unsigned count = 0;
+    for (std::size_t i = 0; i < w.a.size(); ++i) {
+      count += products_equal_branchless(w.a[i], w.b[i], w.c[i], w.d[i]);
+    }
+    return count;
+  };
+}
+} // namespace
+
+TEST_CASE("Benchmark equality by workload", "[!benchmark]")
+{
+  benchmark_workload("equal heavy, 2**12 elements", 0.9);
+  benchmark_workload("mixed, 2**12 elements", 0.5);
+  benchmark_workload("unequal heavy, 2**12 elements", 0.1);
+}
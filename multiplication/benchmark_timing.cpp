@@ -0,0 +1,221 @@
+// measures the distribution of the time per call for different classes of
+// input, to check that the constant time variants do not depend on the
+// operands while products_equal() and multiply_modulo do.
+//
+// each sample is a chain of calls where the next input depends on the
+// previous result, so it measures latency, which is what leaks. prints the
+// median and spread in cycles per call for every kernel and input class as
+// csv.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+#include "montgomery.h"
+#include "multiplication.h"
+
+namespace {
+
+/// makes the compiler assume value is read and modified
+template<typename T>
+void
+do_not_optimize(T& value)
+{
+  asm volatile("" : "+r"(value) : : "memory");
+}
+
+/// time stamp counter ticks, or nanoseconds where there is no such counter
+std::uint64_t
+now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_lfence();
+  const auto ret = __rdtsc();
+  _mm_lfence();
+  return ret;
+#else
+  return static_cast<std::uint64_t>(
+    std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/// the modulus for the multiply_modulo kernels
+constexpr auto modulus = crt_moduli::values[0];
+
+struct Operands
+{
+  std::uint32_t a, b, c, d;
+};
+
+/// the input classes. these decide at different stages of products_equal(),
+/// and give the % in multiply_modulo() operands of different magnitudes.
+const char* const classes[] = {
+  "zero", "small", "random", "equal", "equal_modulo_2_32", "max",
+};
+
+Operands
+make_operands(const std::string& name, std::mt19937& rng)
+{
+  const auto r = [&] { return static_cast<std::uint32_t>(rng()); };
+  if (name == "zero") {
+    return { 0, 0, 0, 0 };
+  }
+  if (name == "small") {
+    return { r() % 16, r() % 16, r() % 16, r() % 16 };
+  }
+  if (name == "equal") {
+    const std::uint32_t x[4] = { r() >> 16, r() >> 16, r() >> 16, r() >> 16 };
+    return { x[0] * x[1], x[2] * x[3], x[0] * x[2], x[1] * x[3] };
+  }
+  if (name == "equal_modulo_2_32") {
+    const std::uint32_t a = r() & ~1U;
+    const std::uint32_t b = r();
+    return { a, b, a, b + (1U << 31) };
+  }
+  if (name == "max") {
+    return { UINT32_MAX - r() % 16,
+             UINT32_MAX - r() % 16,
+             UINT32_MAX - r() % 16,
+             UINT32_MAX - r() % 16 };
+  }
+  return { r(), r(), r(), r() };
+}
+
+/**
+ * times chains of calls on operands of one class
+ * @return the time per call, for each sample
+ */
+template<typename Kernel>
+std::vector<double>
+measure(const std::vector<Operands>& operands, Kernel kernel)
+{
+  constexpr int chain = 32;
+  std::vector<double> ret;
+  ret.reserve(operands.size());
+  // opaque zero, so the dependency on the previous result does not change
+  // the operands but the compiler can not remove it
+  std::uint32_t zero = 0;
+  do_not_optimize(zero);
+  for (const auto& o : operands) {
+    std::uint32_t dependency = 0;
+    const auto start = now();
+    for (int i = 0; i < chain; ++i) {
+      const std::uint32_t result =
+        kernel(o.a ^ dependency, o.b, o.c ^ dependency, o.d);
+      dependency = result * zero;
+    }
+    const auto stop = now();
+    do_not_optimize(dependency);
+    ret.push_back(static_cast<double>(stop - start) / chain);
+  }
+  return ret;
+}
+
+/// the p'th percentile, sorts x
+double
+percentile(std::vector<double>& x, const double p)
+{
+  std::sort(x.begin(), x.end());
+  return x[static_cast<std::size_t>(p * static_cast<double>(x.size() - 1))];
+}
+
+template<typename Kernel>
+void
+report(const char* kernel_name, const std::size_t samples, Kernel kernel)
+{
+  std::mt19937 rng;
+  constexpr std::size_t nclasses = std::size(classes);
+  std::vector<Operands> operands[nclasses];
+  for (std::size_t c = 0; c < nclasses; ++c) {
+    for (std::size_t i = 0; i < samples; ++i) {
+      operands[c].push_back(make_operands(classes[c], rng));
+    }
+  }
+  // the classes take turns in small batches, so drift in clock frequency
+  // or other load affects all of them alike
+  constexpr std::size_t batch = 16;
+  std::vector<double> t[nclasses];
+  for (std::size_t i = 0; i < samples; i += batch) {
+    for (std::size_t c = 0; c < nclasses; ++c) {
+      const auto n = std::min(batch, samples - i);
+      const std::vector<Operands> chunk(operands[c].begin() + i,
+                                        operands[c].begin() + i + n);
+      const auto times = measure(chunk, kernel);
+      t[c].insert(t[c].end(), times.begin(), times.end());
+    }
+  }
+  for (std::size_t c = 0; c < nclasses; ++c) {
+    std::printf("%s,%s,%zu,%.2f,%.2f,%.2f,%.2f\n",
+                kernel_name,
+                classes[c],
+                samples,
+                percentile(t[c], 0.5),
+                percentile(t[c], 0.1),
+                percentile(t[c], 0.9),
+                percentile(t[c], 0.99));
+  }
+}
+
+template<typename T>
+T
+parse(const char* arg)
+{
+  std::stringstream x(arg);
+  T value;
+  if (!(x >> value) || !x.eof()) {
+    std::fprintf(stderr, "failed parse of %s\n", arg);
+    std::exit(EXIT_FAILURE);
+  }
+  return value;
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t samples = 10000;
+  const bool has_samples = argc == 3 && std::string(argv[1]) == "-n";
+  if (has_samples) {
+    samples = parse<std::size_t>(argv[2]);
+  }
+  if ((argc != 1 && !has_samples) || samples == 0) {
+    std::fprintf(stderr, "usage: %s [-n samples]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  std::printf("kernel,class,samples,median,p10,p90,p99\n");
+  report("multiply_modulo",
+         samples,
+         [](auto a, auto b, auto, auto) {
+           return multiply_modulo<modulus>(a, b);
+         });
+  report("multiply_modulo_constant_time",
+         samples,
+         [](auto a, auto b, auto, auto) {
+           return multiply_modulo_constant_time<modulus>(a, b);
+         });
+  report("products_equal",
+         samples,
+         [](auto a, auto b, auto c, auto d) {
+           return std::uint32_t{ products_equal(a, b, c, d) };
+         });
+  report("products_equal_constant_time",
+         samples,
+         [](auto a, auto b, auto c, auto d) {
+           return std::uint32_t{ products_equal_constant_time(a, b, c, d) };
+         });
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+// generated by select_moduli, do not edit
+//   select_moduli
+// expected ns per comparison when generated:
+//   random 4.41, equal 33.80, adversarial 13.98
+
+#include <cstdint>
+
+namespace crt_moduli {
+/// the operand width the moduli were selected for
+inline constexpr unsigned operand_bits = 32;
+/// pairwise coprime odd moduli, checked in this order after 2**32
+inline constexpr std::uint32_t values[] = { 65533, 65535, 65527 };
+} // namespace crt_moduli
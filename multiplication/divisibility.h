@@ -0,0 +1,134 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+/// the inverse of odd m modulo 2**32, with newton iteration. m is its own
+/// inverse modulo 8 and each step doubles the number of correct bits.
+constexpr std::uint32_t
+inverse_modulo_2_32(const std::uint32_t m)
+{
+  std::uint32_t inverse = m;
+  for (int i = 0; i < 4; ++i) {
+    inverse *= 2 - m * inverse;
+  }
+  return inverse;
+}
+
+/**
+ * the constants for testing divisibility by M = 2**shift * odd, by
+ * Granlund and Montgomery. multiplying by the inverse of odd maps the
+ * multiples of odd onto 0..(2**32-1)/odd and everything else above it. the
+ * rotation moves low bits which are set, which means x is not a multiple of
+ * 2**shift, to the top so those also end up above the limit.
+ */
+template<std::uint32_t M>
+struct Divisibility
+{
+  static_assert(M != 0, "division by zero");
+  static constexpr int shift = std::countr_zero(M);
+  static constexpr std::uint32_t inverse = inverse_modulo_2_32(M >> shift);
+  static constexpr std::uint32_t limit = UINT32_MAX / M;
+  static_assert((M >> shift) * inverse == 1);
+};
+} // namespace detail
+
+/**
+ * @return true if M divides x, the same as x % M == 0 but with one
+ * multiplication and no division
+ */
+template<std::uint32_t M>
+constexpr bool
+is_divisible(const std::uint32_t x)
+{
+  using D = detail::Divisibility<M>;
+  return std::rotr(x * D::inverse, D::shift) <= D::limit;
+}
+
+namespace detail {
+/// the mask for n <= 64 elements, one at a time
+template<std::uint32_t M>
+std::uint64_t
+is_divisible_scalar(const std::uint32_t* x, const std::size_t n)
+{
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    mask |= std::uint64_t{ is_divisible<M>(x[i]) } << i;
+  }
+  return mask;
+}
+
+/// the mask for 64 elements
+template<std::uint32_t M>
+std::uint64_t
+is_divisible_block(const std::uint32_t* x)
+{
+#if defined(__AVX512F__)
+  using D = Divisibility<M>;
+  const __m512i inverse = _mm512_set1_epi32(static_cast<int>(D::inverse));
+  const __m512i limit = _mm512_set1_epi32(static_cast<int>(D::limit));
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < 64; i += 16) {
+    const __m512i v = _mm512_loadu_si512(x + i);
+    // the maskz form avoids a false -Wmaybe-uninitialized from gcc 12
+    const __m512i rotated = _mm512_maskz_ror_epi32(
+      0xFFFF, _mm512_mullo_epi32(v, inverse), D::shift);
+    mask |= std::uint64_t{ _mm512_cmple_epu32_mask(rotated, limit) } << i;
+  }
+  return mask;
+#elif defined(__AVX2__)
+  using D = Divisibility<M>;
+  const __m256i inverse = _mm256_set1_epi32(static_cast<int>(D::inverse));
+  const __m256i limit = _mm256_set1_epi32(static_cast<int>(D::limit));
+  std::uint64_t mask = 0;
+  for (std::size_t i = 0; i < 64; i += 8) {
+    const __m256i v =
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+    const __m256i product = _mm256_mullo_epi32(v, inverse);
+    __m256i rotated = product;
+    if constexpr (D::shift != 0) {
+      rotated = _mm256_or_si256(_mm256_srli_epi32(product, D::shift),
+                                _mm256_slli_epi32(product, 32 - D::shift));
+    }
+    // there is no unsigned comparison, but min(a, b) == a is a <= b
+    const __m256i le =
+      _mm256_cmpeq_epi32(_mm256_min_epu32(rotated, limit), rotated);
+    const int bits = _mm256_movemask_ps(_mm256_castsi256_ps(le));
+    mask |= static_cast<std::uint64_t>(bits) << i;
+  }
+  return mask;
+#else
+  return is_divisible_scalar<M>(x, 64);
+#endif
+}
+} // namespace detail
+
+/**
+ * tests is_divisible<M>(x[i]) for all i. this is vectorized if compiled for
+ * AVX2 or AVX-512, otherwise the elements are tested one at a time.
+ * @param mask bit i%64 of mask[i/64] is set if M divides x[i]. it must have
+ * room for x.size() bits. the unused bits of the last word are cleared.
+ */
+template<std::uint32_t M>
+void
+is_divisible_batch(std::span<const std::uint32_t> x,
+                   std::span<std::uint64_t> mask)
+{
+  const std::size_t n = x.size();
+  assert(mask.size() * 64 >= n);
+  std::size_t i = 0;
+  for (; i + 64 <= n; i += 64) {
+    mask[i / 64] = detail::is_divisible_block<M>(&x[i]);
+  }
+  if (i < n) {
+    mask[i / 64] = detail::is_divisible_scalar<M>(&x[i], n - i);
+  }
+}
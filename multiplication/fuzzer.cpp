@@ -1,6 +1,7 @@
 #include "multiplication.h"
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
@@ -16,6 +17,25 @@ reference_products_equal(const unsigned a,
   return U{ a } * b == U{ c } * d;
 }
 
+bool
+reference_products_equal(const std::array<std::uint64_t, 2>& lhs,
+                         const std::array<std::uint64_t, 2>& rhs)
+{
+  __extension__ typedef unsigned __int128 U;
+  return U{ lhs[0] } * lhs[1] == U{ rhs[0] } * rhs[1];
+}
+
+template<std::size_t K>
+void
+check_n_term(const std::array<std::uint64_t, K>& lhs,
+             const std::array<std::uint64_t, K>& rhs)
+{
+  if (products_equal_crt(lhs, rhs) != products_equal_int128(lhs, rhs)) {
+    std::cerr << "found test case with " << K << " factors\n";
+    std::abort();
+  }
+}
+
 extern "C" int
 LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
 {
@@ -31,5 +51,35 @@ LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
               << d << '\n';
     std::abort();
   }
+
+  // 64 bit factors made from the same 32 bit pieces have equal products,
+  // which random input would almost never give
+  const std::array<std::uint64_t, 2> lhs{ std::uint64_t{ a } * b,
+                                          std::uint64_t{ c } * d };
+  const std::array<std::uint64_t, 2> rhs{ std::uint64_t{ a } * c,
+                                          std::uint64_t{ b } * d };
+  if (!products_equal_crt(lhs, rhs) || !products_equal(lhs, rhs)) {
+    std::cerr << "found equal 64 bit products reported as different\n";
+    std::abort();
+  }
+
+  std::uint64_t longs[6]{};
+  if (Size < sizeof(longs)) {
+    return 0;
+  }
+  std::memcpy(&longs[0], Data, sizeof(longs));
+  const std::array<std::uint64_t, 2> lhs2{ longs[0], longs[1] };
+  const std::array<std::uint64_t, 2> rhs2{ longs[2], longs[3] };
+  const bool expected = reference_products_equal(lhs2, rhs2);
+  if (expected != products_equal_crt(lhs2, rhs2) ||
+      expected != products_equal(lhs2, rhs2)) {
+    std::cerr << "found test case " << longs[0] << " * " << longs[1]
+              << " != " << longs[2] << " * " << longs[3] << '\n';
+    std::abort();
+  }
+  check_n_term(std::array{ longs[0], longs[1], longs[2] },
+               std::array{ longs[3], longs[4], longs[5] });
+  check_n_term(std::array{ lhs[0], lhs[1], longs[4] },
+               std::array{ rhs[0], rhs[1], longs[4] });
   return 0;
 }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include "crt_moduli.h"
+#include "divisibility.h"
+#include "multiplication.h"
+
+/**
+ * montgomery multiplication modulo an odd N < 2**31, with R = 2**32.
+ *
+ * there are no branches or divisions, so the time does not depend on the
+ * operands. the only data dependent step, the final conditional
+ * subtraction, is done with a mask.
+ */
+template<std::uint32_t N>
+class Montgomery
+{
+  static_assert(N % 2 == 1, "the modulus must be odd");
+  static_assert(N < (1U << 31), "t + m*N in reduce() must fit in 64 bits");
+
+public:
+  /// -1/N modulo 2**32
+  static constexpr std::uint32_t minus_inverse =
+    0U - detail::inverse_modulo_2_32(N);
+  /// R**2 modulo N
+  static constexpr std::uint32_t r_squared =
+    static_cast<std::uint32_t>((std::uint64_t{ 1 } << 63) % N * 2 % N);
+
+  /**
+   * @param t less than N*2**32
+   * @return t/R modulo N
+   */
+  static constexpr std::uint32_t reduce(const std::uint64_t t)
+  {
+    const std::uint32_t m = static_cast<std::uint32_t>(t) * minus_inverse;
+    // t + m*N is divisible by R and the quotient is less than 2N
+    const std::uint64_t u = (t + std::uint64_t{ m } * N) >> 32;
+    const std::uint64_t subtracted = u - N;
+    // all ones if the subtraction borrowed, that is if u < N
+    const std::uint64_t keep = 0 - (subtracted >> 63);
+    return static_cast<std::uint32_t>((u & keep) | (subtracted & ~keep));
+  }
+
+  /// @return x*R modulo N, for any 32 bit x
+  static constexpr std::uint32_t to_montgomery(const std::uint32_t x)
+  {
+    return reduce(std::uint64_t{ x } * r_squared);
+  }
+
+  /// @return x modulo N, for x in montgomery form
+  static constexpr std::uint32_t from_montgomery(const std::uint32_t x)
+  {
+    return reduce(x);
+  }
+
+  /// @return x*y modulo N, for any 32 bit x and y
+  static constexpr std::uint32_t multiply(const std::uint32_t x,
+                                          const std::uint32_t y)
+  {
+    // x*R * y / R, where x*R < N so the product is less than N*2**32
+    return reduce(std::uint64_t{ to_montgomery(x) } * y);
+  }
+};
+
+/**
+ * same as multiply_modulo, but in constant time
+ * @return xy mod a_i
+ */
+template<std::uint32_t a_i>
+constexpr std::uint32_t
+multiply_modulo_constant_time(const std::uint32_t x, const std::uint32_t y)
+{
+  return Montgomery<a_i>::multiply(x, y);
+}
+
+namespace detail {
+template<std::size_t... I>
+constexpr std::uint32_t
+residue_differences(const std::uint32_t a,
+                    const std::uint32_t b,
+                    const std::uint32_t c,
+                    const std::uint32_t d,
+                    std::index_sequence<I...>)
+{
+  return ((multiply_modulo_constant_time<crt_moduli::values[I]>(a, b) ^
+           multiply_modulo_constant_time<crt_moduli::values[I]>(c, d)) |
+          ...);
+}
+} // namespace detail
+
+/**
+ * same as products_equal(), but in constant time. all residues are
+ * computed, with montgomery multiplication instead of %, and the
+ * differences are combined with bitwise or so there is no early exit.
+ */
+constexpr bool
+products_equal_constant_time(const std::uint32_t a,
+                             const std::uint32_t b,
+                             const std::uint32_t c,
+                             const std::uint32_t d)
+{
+  static_assert(detail::crt_moduli_are_valid());
+  const std::uint32_t differences =
+    ((a * b) ^ (c * d)) |
+    detail::residue_differences(
+      a,
+      b,
+      c,
+      d,
+      std::make_index_sequence<std::size(crt_moduli::values)>{});
+  return differences == 0;
+}
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
+#include <utility>
+
+#include "crt_moduli.h"
 
 /**
  * multiplies x and y modulo a_i, while avoiding
@@ -16,6 +21,54 @@ multiply_modulo(const std::uint32_t x, const std::uint32_t y)
   return (xm * ym) % a_i;
 }
 
+namespace detail {
+/**
+ * true if the moduli in crt_moduli.h are odd, pairwise coprime and small
+ * enough for multiply_modulo, and together with 2**32 exceed all products of
+ * two 32 bit numbers
+ */
+constexpr bool
+crt_moduli_are_valid()
+{
+  constexpr std::size_t n = std::size(crt_moduli::values);
+  std::uint64_t product = 1;
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto m = crt_moduli::values[i];
+    if (m % 2 == 0 || m > 65536) {
+      return false;
+    }
+    for (std::size_t j = i + 1; j < n; ++j) {
+      auto x = m;
+      auto y = crt_moduli::values[j];
+      while (y != 0) {
+        x = std::exchange(y, x % y);
+      }
+      if (x != 1) {
+        return false;
+      }
+    }
+    if (product < 0xFFFFFFFF) {
+      product *= m;
+    }
+  }
+  // 2**32 * product > (2**32 - 1)**2 if and only if product >= 2**32 - 1
+  return product >= 0xFFFFFFFF;
+}
+
+template<std::size_t... I>
+constexpr bool
+products_equal_modulo(const std::uint32_t a,
+                      const std::uint32_t b,
+                      const std::uint32_t c,
+                      const std::uint32_t d,
+                      std::index_sequence<I...>)
+{
+  return ((multiply_modulo<crt_moduli::values[I]>(a, b) ==
+           multiply_modulo<crt_moduli::values[I]>(c, d)) &&
+          ...);
+}
+} // namespace detail
+
 /**
  * returns true if a*b == c*d, determined while avoiding
  * overflow
@@ -31,29 +84,178 @@ products_equal(const std::uint32_t a,
                const std::uint32_t c,
                const std::uint32_t d)
 {
-  // we use the chinese remainder theorem with four coefficients
+  // we use the chinese remainder theorem with 2**32 and the coefficients in
+  // crt_moduli.h
+  static_assert(crt_moduli::operand_bits == 32,
+                "crt_moduli.h was generated for another operand width");
+  static_assert(detail::crt_moduli_are_valid());
 
   // carry out the comparision modulo a_1=2**32 which is fast
   if (a * b != c * d) {
     return false;
   }
-  // this coefficient was chosen after benchmarking
-  constexpr std::uint32_t a_2 = 65485;
-  if (multiply_modulo<a_2>(a, b) != multiply_modulo<a_2>(c, d)) {
-    return false;
+  // the other coefficients were chosen by select_moduli, the comparisons
+  // stop at the first one that differs
+  return detail::products_equal_modulo(
+    a, b, c, d, std::make_index_sequence<std::size(crt_moduli::values)>{});
+}
+
+namespace detail {
+template<std::size_t... I>
+constexpr bool
+all_residues_equal(const std::uint32_t a,
+                   const std::uint32_t b,
+                   const std::uint32_t c,
+                   const std::uint32_t d,
+                   std::index_sequence<I...>)
+{
+  // & instead of && evaluates all of them, without branches
+  return ((multiply_modulo<crt_moduli::values[I]>(a, b) ==
+           multiply_modulo<crt_moduli::values[I]>(c, d)) &
+          ...);
+}
+} // namespace detail
+
+/**
+ * same as products_equal(), but computes all residues and combines them
+ * instead of stopping at the first that differs. this avoids unpredictable
+ * branches when many products pass the first comparison, at the cost of
+ * always computing every residue. which one is faster depends on the
+ * workload and the target, see ProductsEqualCounters and
+ * benchmark_equality.
+ */
+constexpr bool
+products_equal_branchless(const std::uint32_t a,
+                          const std::uint32_t b,
+                          const std::uint32_t c,
+                          const std::uint32_t d)
+{
+  const bool low_equal = a * b == c * d;
+  return low_equal &
+         detail::all_residues_equal(
+           a,
+           b,
+           c,
+           d,
+           std::make_index_sequence<std::size(crt_moduli::values)>{});
+}
+
+namespace detail {
+/// the largest primes below 2**32, so the product of two residues fits in 64
+/// bits
+inline constexpr std::uint32_t crt_primes[] = {
+  4294967291U, 4294967279U, 4294967231U, 4294967197U,
+  4294967189U, 4294967161U, 4294967143U, 4294967111U,
+  4294967087U, 4294967029U, 4294966997U, 4294966981U,
+  4294966943U, 4294966927U, 4294966909U, 4294966877U,
+};
+
+/// the product of all elements of x, modulo m
+template<std::uint64_t m, std::size_t K>
+constexpr std::uint64_t
+product_modulo(const std::array<std::uint64_t, K>& x)
+{
+  std::uint64_t product = 1;
+  for (const auto factor : x) {
+    product = (product * (factor % m)) % m;
   }
+  return product;
+}
 
-  // this coefficient was chosen after benchmarking
-  constexpr std::uint32_t a_3 = 65483;
-  if (multiply_modulo<a_3>(a, b) != multiply_modulo<a_3>(c, d)) {
+template<std::size_t K, std::size_t... I>
+constexpr bool
+products_equal_modulo_primes(const std::array<std::uint64_t, K>& lhs,
+                             const std::array<std::uint64_t, K>& rhs,
+                             std::index_sequence<I...>)
+{
+  return ((product_modulo<crt_primes[I]>(lhs) ==
+           product_modulo<crt_primes[I]>(rhs)) &&
+          ...);
+}
+} // namespace detail
+
+/**
+ * returns true if lhs[0]*...*lhs[K-1] == rhs[0]*...*rhs[K-1], determined
+ * with the chinese remainder theorem. the products are less than 2**(64K),
+ * so comparing them modulo 2**64 and 2K primes just below 2**32 is exact.
+ * only 64 bit arithmetic is used.
+ */
+template<std::size_t K>
+constexpr bool
+products_equal_crt(const std::array<std::uint64_t, K>& lhs,
+                   const std::array<std::uint64_t, K>& rhs)
+{
+  static_assert(K >= 1);
+  static_assert(2 * K <= std::size(detail::crt_primes),
+                "not enough moduli for this many factors");
+
+  // carry out the comparision modulo 2**64 first, which is fast
+  std::uint64_t lhs_product = 1;
+  std::uint64_t rhs_product = 1;
+  for (std::size_t i = 0; i < K; ++i) {
+    lhs_product *= lhs[i];
+    rhs_product *= rhs[i];
+  }
+  if (lhs_product != rhs_product) {
     return false;
   }
+  return detail::products_equal_modulo_primes(
+    lhs, rhs, std::make_index_sequence<2 * K>{});
+}
 
-  // this coefficient was chosen after benchmarking
-  constexpr std::uint32_t a_4 = 65481;
-  if (multiply_modulo<a_4>(a, b) != multiply_modulo<a_4>(c, d)) {
-    return false;
+#if defined(__SIZEOF_INT128__)
+namespace detail {
+/// the exact product of all elements of x, as K limbs with the least
+/// significant first
+template<std::size_t K>
+constexpr std::array<std::uint64_t, K>
+full_product(const std::array<std::uint64_t, K>& x)
+{
+  __extension__ typedef unsigned __int128 uint128;
+  std::array<std::uint64_t, K> product{};
+  product[0] = x[0];
+  for (std::size_t i = 1; i < K; ++i) {
+    // the product of the first i factors fits in i limbs
+    std::uint64_t carry = 0;
+    for (std::size_t j = 0; j < i; ++j) {
+      const uint128 t = uint128{ product[j] } * x[i] + carry;
+      product[j] = static_cast<std::uint64_t>(t);
+      carry = static_cast<std::uint64_t>(t >> 64);
+    }
+    product[i] = carry;
   }
+  return product;
+}
+} // namespace detail
 
-  return true;
+/**
+ * returns true if lhs[0]*...*lhs[K-1] == rhs[0]*...*rhs[K-1], determined by
+ * computing both products exactly with 64x64->128 bit multiplications.
+ * only available where the compiler supports unsigned __int128.
+ */
+template<std::size_t K>
+constexpr bool
+products_equal_int128(const std::array<std::uint64_t, K>& lhs,
+                      const std::array<std::uint64_t, K>& rhs)
+{
+  static_assert(K >= 1);
+  return detail::full_product(lhs) == detail::full_product(rhs);
+}
+#endif
+
+/**
+ * returns true if the products of the K 64 bit factors in lhs and rhs are
+ * equal. uses products_equal_int128() where available, which was faster in
+ * benchmark_equality, and products_equal_crt() otherwise.
+ */
+template<std::size_t K>
+constexpr bool
+products_equal(const std::array<std::uint64_t, K>& lhs,
+               const std::array<std::uint64_t, K>& rhs)
+{
+#if defined(__SIZEOF_INT128__)
+  return products_equal_int128(lhs, rhs);
+#else
+  return products_equal_crt(lhs, rhs);
+#endif
 }
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+
+#include "multiplication.h"
+
+/// the number of comparisons in products_equal(), the first is modulo 2**32
+inline constexpr std::size_t products_equal_stages =
+  1 + std::size(crt_moduli::values);
+
+namespace detail {
+template<std::size_t... I>
+constexpr std::size_t
+deciding_stage(const std::uint32_t a,
+               const std::uint32_t b,
+               const std::uint32_t c,
+               const std::uint32_t d,
+               std::index_sequence<I...>)
+{
+  if (a * b != c * d) {
+    return 0;
+  }
+  // counts the stages passed, stopping at the first that differs
+  std::size_t stage = 1;
+  static_cast<void>(((multiply_modulo<crt_moduli::values[I]>(a, b) ==
+                        multiply_modulo<crt_moduli::values[I]>(c, d) &&
+                      ++stage) &&
+                     ...));
+  return stage;
+}
+} // namespace detail
+
+/**
+ * the stage of products_equal() which decided that the products differ, or
+ * products_equal_stages if they are equal
+ */
+constexpr std::size_t
+products_equal_deciding_stage(const std::uint32_t a,
+                              const std::uint32_t b,
+                              const std::uint32_t c,
+                              const std::uint32_t d)
+{
+  return detail::deciding_stage(
+    a, b, c, d, std::make_index_sequence<std::size(crt_moduli::values)>{});
+}
+
+/**
+ * compares products like products_equal() while counting which stage
+ * decided, to choose between products_equal() and
+ * products_equal_branchless() for a workload.
+ */
+class ProductsEqualCounters
+{
+public:
+  /// @return a*b == c*d
+  constexpr bool operator()(const std::uint32_t a,
+                            const std::uint32_t b,
+                            const std::uint32_t c,
+                            const std::uint32_t d)
+  {
+    const auto stage = products_equal_deciding_stage(a, b, c, d);
+    ++m_counts[stage];
+    return stage == products_equal_stages;
+  }
+
+  /// the number of comparisons decided by stage, or the number of equal
+  /// products for stage == products_equal_stages
+  constexpr std::uint64_t count(const std::size_t stage) const
+  {
+    return m_counts.at(stage);
+  }
+
+  constexpr std::uint64_t total() const
+  {
+    std::uint64_t ret = 0;
+    for (const auto n : m_counts) {
+      ret += n;
+    }
+    return ret;
+  }
+
+  /**
+   * the fraction of comparisons which got past the first stage. these
+   * compute at least one more residue in products_equal(), and a fraction
+   * near one half makes the branches hard to predict. only when this is
+   * large can products_equal_branchless() win.
+   */
+  constexpr double past_first_stage() const
+  {
+    const auto n = total();
+    return n == 0 ? 0.0 : static_cast<double>(n - m_counts[0]) / n;
+  }
+
+  constexpr void reset() { m_counts = {}; }
+
+private:
+  std::array<std::uint64_t, products_equal_stages + 1> m_counts{};
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+/**
+ * a divisor which is only known at runtime, for when the compiler can not
+ * strength reduce % like it does for multiply_modulo<a_i>.
+ *
+ * uses the direct remainder computation by Lemire, Kaser and Kurz: with
+ * M = ceil(2**F / d), the fractional part of x/d is M*x mod 2**F, and
+ * multiplying it by d gives the remainder in the high bits. F = 64 is exact
+ * for 32 bit x and F = 128 for 64 bit x, so the constants are computed once
+ * and each operation is a few multiplications instead of a division.
+ *
+ * only available where the compiler supports unsigned __int128.
+ */
+#if defined(__SIZEOF_INT128__)
+class RuntimeDivisor
+{
+public:
+  /**
+   * precomputes the constants
+   * @param d the divisor, must not be zero
+   */
+  constexpr explicit RuntimeDivisor(const std::uint32_t d)
+    : m_d(d)
+    , m_M(~std::uint64_t{} / d + 1)
+    , m_M128(~uint128{} / d + 1)
+  {
+    assert(d != 0);
+  }
+
+  constexpr std::uint32_t divisor() const { return m_d; }
+
+  /**
+   * @return x mod d
+   */
+  constexpr std::uint32_t mod(const std::uint32_t x) const
+  {
+    const std::uint64_t fraction = m_M * x;
+    return static_cast<std::uint32_t>((uint128{ fraction } * m_d) >> 64);
+  }
+
+  /**
+   * multiplies x and y modulo d. the full 64 bit product is reduced
+   * directly, so there is no need to reduce x and y first.
+   * @return xy mod d
+   */
+  constexpr std::uint32_t mulmod(const std::uint32_t x,
+                                 const std::uint32_t y) const
+  {
+    const std::uint64_t product = std::uint64_t{ x } * y;
+    const uint128 fraction = m_M128 * product;
+    // the high 64 bits of the 192 bit product fraction * d
+    const uint128 low = (uint128{ static_cast<std::uint64_t>(fraction) } *
+                         m_d) >>
+                        64;
+    const uint128 high =
+      uint128{ static_cast<std::uint64_t>(fraction >> 64) } * m_d;
+    return static_cast<std::uint32_t>((high + low) >> 64);
+  }
+
+  /**
+   * @return true if d divides x, which is the case if the fractional part
+   * of x/d is less than 1/d
+   */
+  constexpr bool divides(const std::uint32_t x) const
+  {
+    return m_M * x <= m_M - 1;
+  }
+
+private:
+  __extension__ typedef unsigned __int128 uint128;
+
+  std::uint32_t m_d;
+  // ceil(2**64 / d), which wraps to zero for d == 1
+  std::uint64_t m_M;
+  // ceil(2**128 / d)
+  uint128 m_M128;
+};
+#endif
@@ -0,0 +1,520 @@
+// selects the moduli for the chinese remainder comparison in products_equal()
+// and writes them as crt_moduli.h.
+//
+// products_equal() first compares a*b and c*d modulo 2**bits, then modulo
+// each of the selected moduli until one differs. a set of moduli is usable
+// if they are odd, pairwise coprime, at most 2**16 so multiply_modulo does
+// not overflow, and together with 2**bits exceed all products. among the
+// usable sets with the fewest moduli, the one with the lowest expected time
+// per comparison is selected, where the time of each modulus is measured
+// and the fraction of comparisons reaching it is measured on sample data.
+//
+// regenerate the header with
+//   select_moduli -o crt_moduli.h
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include "multiplication.h"
+
+namespace {
+
+__extension__ typedef unsigned __int128 uint128;
+
+/// the candidates are the odd numbers counting down from 2**16 - 1
+constexpr std::size_t max_pool_size = 48;
+
+constexpr std::uint32_t
+candidate(const std::size_t i)
+{
+  return static_cast<std::uint32_t>(65535 - 2 * i);
+}
+
+/// comparisons of a*b with c*d
+struct Samples
+{
+  std::string name;
+  std::vector<std::uint32_t> a, b, c, d;
+};
+
+constexpr std::size_t sample_count = 1 << 14;
+
+Samples
+make_random(const unsigned bits, std::mt19937& rng)
+{
+  Samples s{ "random", {}, {}, {}, {} };
+  const std::uint32_t mask = 0xFFFFFFFF >> (32 - bits);
+  for (std::size_t i = 0; i < sample_count; ++i) {
+    s.a.push_back(rng() & mask);
+    s.b.push_back(rng() & mask);
+    s.c.push_back(rng() & mask);
+    s.d.push_back(rng() & mask);
+  }
+  return s;
+}
+
+/// equal products, made by pairing the same factors in different ways
+Samples
+make_equal(const unsigned bits, std::mt19937& rng)
+{
+  Samples s{ "equal", {}, {}, {}, {} };
+  const std::uint32_t mask = 0xFFFFFFFF >> (32 - bits / 2);
+  for (std::size_t i = 0; i < sample_count; ++i) {
+    std::uint32_t x[4];
+    for (auto& piece : x) {
+      piece = static_cast<std::uint32_t>(rng()) & mask;
+    }
+    s.a.push_back(x[0] * x[1]);
+    s.b.push_back(x[2] * x[3]);
+    s.c.push_back(x[0] * x[2]);
+    s.d.push_back(x[1] * x[3]);
+  }
+  return s;
+}
+
+/**
+ * products which are equal modulo 2**bits but differ by k*2**bits, where k
+ * is a product of small primes. these pass the first comparison, and also
+ * every modulus which shares a factor with k.
+ */
+Samples
+make_adversarial(const unsigned bits, std::mt19937& rng)
+{
+  Samples s{ "adversarial", {}, {}, {}, {} };
+  constexpr std::uint32_t small_primes[] = { 3,  5,  7,  11, 13, 17, 19,
+                                             23, 29, 31, 37, 41, 43, 47 };
+  const std::uint64_t limit = std::uint64_t{ 1 } << bits;
+  for (std::size_t i = 0; i < sample_count; ++i) {
+    const unsigned shift = 1 + rng() % (bits - 1);
+    std::uint64_t k = 1;
+    for (int j = 0; j < 8; ++j) {
+      const auto p = small_primes[rng() % std::size(small_primes)];
+      if ((k * p) << shift < limit) {
+        k *= p;
+      }
+    }
+    const auto a = static_cast<std::uint32_t>(k << shift);
+    const std::uint64_t b = rng() % limit;
+    const std::uint64_t step = limit >> shift;
+    const auto d = b + step < limit ? b + step : b - step;
+    s.a.push_back(a);
+    s.b.push_back(static_cast<std::uint32_t>(b));
+    s.c.push_back(a);
+    s.d.push_back(static_cast<std::uint32_t>(d));
+  }
+  return s;
+}
+
+/// bit i is set if sample i is equal modulo m, so m does not decide it
+using Bitset = std::vector<std::uint64_t>;
+
+Bitset
+equal_modulo(const Samples& s, const std::uint64_t m)
+{
+  Bitset ret(sample_count / 64);
+  for (std::size_t i = 0; i < sample_count; ++i) {
+    const bool equal = std::uint64_t{ s.a[i] } * s.b[i] % m ==
+                       std::uint64_t{ s.c[i] } * s.d[i] % m;
+    ret[i / 64] |= std::uint64_t{ equal } << (i % 64);
+  }
+  return ret;
+}
+
+/// the time of one comparison, which must return true if the products are
+/// equal. each comparison depends on the previous, so the loop can not be
+/// vectorized while products_equal() is not.
+template<typename Compare>
+double
+measure_ns(const Samples& s, Compare compare)
+{
+  constexpr std::size_t iterations = 1 << 20;
+  double best = std::numeric_limits<double>::max();
+  std::size_t idx = 0;
+  for (int repetition = 0; repetition < 3; ++repetition) {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+      const bool equal = compare(s.a[idx], s.b[idx], s.c[idx], s.d[idx]);
+      idx = (idx + 1 + equal) % sample_count;
+    }
+    const std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count() / iterations);
+  }
+  volatile std::size_t sink = idx;
+  static_cast<void>(sink);
+  return best;
+}
+
+template<std::size_t... I>
+std::vector<double>
+measure_candidates(const Samples& s, std::index_sequence<I...>)
+{
+  return { measure_ns(s,
+                      [](std::uint32_t a,
+                         std::uint32_t b,
+                         std::uint32_t c,
+                         std::uint32_t d) {
+                        return multiply_modulo<candidate(I)>(a, b) ==
+                               multiply_modulo<candidate(I)>(c, d);
+                      })... };
+}
+
+bool
+covers_products(const unsigned bits, const std::vector<std::uint32_t>& moduli)
+{
+  uint128 product = uint128{ 1 } << bits;
+  for (const auto m : moduli) {
+    product *= m;
+  }
+  const uint128 largest = (uint128{ 1 } << bits) - 1;
+  return product > largest * largest;
+}
+
+bool
+pairwise_coprime(const std::vector<std::uint32_t>& moduli)
+{
+  for (std::size_t i = 0; i < moduli.size(); ++i) {
+    for (std::size_t j = i + 1; j < moduli.size(); ++j) {
+      if (std::gcd(moduli[i], moduli[j]) != 1) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+struct Candidate
+{
+  std::vector<std::size_t> pool_index;
+  std::vector<std::uint32_t> moduli;
+  /// expected ns per comparison, for each sample distribution
+  std::vector<double> cost;
+  double score;
+};
+
+/// calls f for every ordered selection of k out of n indices
+template<typename F>
+void
+for_each_permutation(const std::size_t n, const std::size_t k, F f)
+{
+  std::vector<std::size_t> combination(k);
+  std::iota(combination.begin(), combination.end(), std::size_t{});
+  while (true) {
+    auto permutation = combination;
+    do {
+      f(permutation);
+    } while (std::next_permutation(permutation.begin(), permutation.end()));
+
+    // the next combination, in lexicographic order
+    std::size_t i = k;
+    while (i > 0 && combination[i - 1] == n - k + i - 1) {
+      --i;
+    }
+    if (i == 0) {
+      return;
+    }
+    ++combination[i - 1];
+    for (std::size_t j = i; j < k; ++j) {
+      combination[j] = combination[j - 1] + 1;
+    }
+  }
+}
+
+std::size_t
+popcount(const Bitset& b)
+{
+  std::size_t ret = 0;
+  for (const auto w : b) {
+    ret += static_cast<std::size_t>(std::popcount(w));
+  }
+  return ret;
+}
+
+std::string
+header(const unsigned bits,
+       const std::string& command,
+       const Candidate& best,
+       const std::vector<Samples>& samples)
+{
+  std::string moduli;
+  for (const auto m : best.moduli) {
+    moduli += (moduli.empty() ? "" : ", ") + std::to_string(m);
+  }
+  std::string costs;
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    costs +=
+      fmt::format("{}{} {:.2f}", i ? ", " : "", samples[i].name, best.cost[i]);
+  }
+  return fmt::format(
+    "#pragma once\n"
+    "\n"
+    "// generated by select_moduli, do not edit\n"
+    "//   {}\n"
+    "// expected ns per comparison when generated:\n"
+    "//   {}\n"
+    "\n"
+    "#include <cstdint>\n"
+    "\n"
+    "namespace crt_moduli {{\n"
+    "/// the operand width the moduli were selected for\n"
+    "inline constexpr unsigned operand_bits = {};\n"
+    "/// pairwise coprime odd moduli, checked in this order after 2**{}\n"
+    "inline constexpr std::uint32_t values[] = {{ {} }};\n"
+    "}} // namespace crt_moduli\n",
+    command,
+    costs,
+    bits,
+    bits,
+    moduli);
+}
+
+template<typename T>
+T
+parse(const char* arg)
+{
+  std::stringstream x(arg);
+  T value;
+  if (!(x >> value) || !x.eof()) {
+    fmt::print(stderr, "failed parse of {}\n", arg);
+    std::exit(EXIT_FAILURE);
+  }
+  return value;
+}
+
+void
+usage(const char* argv0)
+{
+  fmt::print(stderr,
+             "usage: {} [-b bits] [-p pool] [-t tolerance] [-w workload]\n"
+             "       [-o file]\n"
+             "  -b bits      operand width 2-32, default 32\n"
+             "  -p pool      the number of candidate moduli counting down\n"
+             "               from 2**16-1, at most {}, default 24\n"
+             "  -t tolerance sets this much slower than the fastest are\n"
+             "               considered equal, default 0.05\n"
+             "  -w workload  random, equal, adversarial or mixed (default)\n"
+             "  -o file      write the header here instead of stdout\n",
+             argv0,
+             max_pool_size);
+  std::exit(EXIT_FAILURE);
+}
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  unsigned bits = 32;
+  std::size_t pool_size = 24;
+  std::string workload = "mixed";
+  double tolerance = 0.05;
+  std::string output;
+  std::string command = "select_moduli";
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-b" && i + 1 < argc) {
+      bits = parse<unsigned>(argv[++i]);
+    } else if (arg == "-p" && i + 1 < argc) {
+      pool_size = parse<std::size_t>(argv[++i]);
+    } else if (arg == "-t" && i + 1 < argc) {
+      tolerance = parse<double>(argv[++i]);
+    } else if (arg == "-w" && i + 1 < argc) {
+      workload = argv[++i];
+    } else if (arg == "-o" && i + 1 < argc) {
+      output = argv[++i];
+      continue;
+    } else {
+      usage(argv[0]);
+    }
+    command += ' ' + arg + ' ' + argv[i];
+  }
+  if (bits < 2 || bits > 32 || pool_size < 1 || pool_size > max_pool_size) {
+    usage(argv[0]);
+  }
+
+  std::mt19937 rng;
+  std::vector<Samples> samples;
+  samples.push_back(make_random(bits, rng));
+  samples.push_back(make_equal(bits, rng));
+  samples.push_back(make_adversarial(bits, rng));
+  std::vector<double> weight(samples.size(), 1.0 / samples.size());
+  if (workload != "mixed") {
+    const auto it =
+      std::find_if(samples.begin(), samples.end(), [&](const Samples& s) {
+        return s.name == workload;
+      });
+    if (it == samples.end()) {
+      usage(argv[0]);
+    }
+    std::fill(weight.begin(), weight.end(), 0.0);
+    weight[static_cast<std::size_t>(it - samples.begin())] = 1.0;
+  }
+
+  // the time per comparison, measured on the samples which reach them
+  const std::uint64_t first_mask = 0xFFFFFFFF >> (32 - bits);
+  const double first_ns =
+    measure_ns(samples[1],
+               [first_mask](std::uint32_t a,
+                            std::uint32_t b,
+                            std::uint32_t c,
+                            std::uint32_t d) {
+                 return ((a * b) & first_mask) == ((c * d) & first_mask);
+               });
+  // in interleaved rounds, so slow drift in clock speed affects all alike
+  std::vector<double> candidate_ns(max_pool_size,
+                                   std::numeric_limits<double>::max());
+  for (int round = 0; round < 5; ++round) {
+    const auto ns = measure_candidates(
+      samples[1], std::make_index_sequence<max_pool_size>{});
+    for (std::size_t i = 0; i < max_pool_size; ++i) {
+      candidate_ns[i] = std::min(candidate_ns[i], ns[i]);
+    }
+  }
+  candidate_ns.resize(pool_size);
+
+  // which samples are decided by each comparison
+  std::vector<Bitset> first_equal;
+  std::vector<std::vector<Bitset>> candidate_equal;
+  for (const auto& s : samples) {
+    first_equal.push_back(equal_modulo(s, first_mask + 1));
+    candidate_equal.emplace_back();
+    for (std::size_t i = 0; i < pool_size; ++i) {
+      candidate_equal.back().push_back(equal_modulo(s, candidate(i)));
+    }
+  }
+
+  // only the smallest number of moduli is considered, more can not be
+  // faster on equal products
+  std::size_t k = 1;
+  while (k <= pool_size) {
+    std::vector<std::uint32_t> largest;
+    for (std::size_t i = 0; i < k; ++i) {
+      largest.push_back(candidate(i));
+    }
+    if (covers_products(bits, largest)) {
+      break;
+    }
+    ++k;
+  }
+  if (k > pool_size) {
+    fmt::print(stderr, "no set of moduli covers {} bit operands\n", bits);
+    return EXIT_FAILURE;
+  }
+
+  std::vector<Candidate> usable;
+  for_each_permutation(pool_size, k, [&](const std::vector<std::size_t>& p) {
+    std::vector<std::uint32_t> moduli;
+    for (const auto i : p) {
+      moduli.push_back(candidate(i));
+    }
+    if (!covers_products(bits, moduli) || !pairwise_coprime(moduli)) {
+      return;
+    }
+    Candidate c{ p, moduli, {}, 0.0 };
+    for (std::size_t s = 0; s < samples.size(); ++s) {
+      auto reaching = first_equal[s];
+      double ns = first_ns;
+      for (const auto i : p) {
+        ns += candidate_ns[i] * popcount(reaching) / sample_count;
+        for (std::size_t w = 0; w < reaching.size(); ++w) {
+          reaching[w] &= candidate_equal[s][i][w];
+        }
+      }
+      c.cost.push_back(ns);
+      c.score += weight[s] * ns;
+    }
+    usable.push_back(std::move(c));
+  });
+
+  // the timing differences between most moduli are within the noise, so
+  // among the sets close to the fastest, the largest moduli checked first
+  // are selected. this makes the selection repeatable.
+  const auto fastest =
+    std::min_element(usable.begin(),
+                     usable.end(),
+                     [](const Candidate& x, const Candidate& y) {
+                       return x.score < y.score;
+                     })
+      ->score;
+  const auto& best =
+    *std::find_if(usable.begin(), usable.end(), [&](const Candidate& c) {
+      return c.score <= fastest * (1 + tolerance);
+    });
+
+  // the report
+  fmt::print(stderr,
+             "{} bit operands, {} candidates, {} usable ordered sets of {}\n",
+             bits,
+             pool_size,
+             usable.size(),
+             k);
+  fmt::print(stderr, "comparison modulo 2**{}: {:.2f} ns\n", bits, first_ns);
+  for (std::size_t i = 0; i < pool_size; ++i) {
+    fmt::print(stderr, "modulo {}: {:.2f} ns\n", candidate(i), candidate_ns[i]);
+  }
+  for (std::size_t s = 0; s < samples.size(); ++s) {
+    auto reaching = first_equal[s];
+    std::string stages = fmt::format(
+      "2**{} {:.4f}", bits, 1.0 - double(popcount(reaching)) / sample_count);
+    for (const auto i : best.pool_index) {
+      const auto before = popcount(reaching);
+      for (std::size_t w = 0; w < reaching.size(); ++w) {
+        reaching[w] &= candidate_equal[s][i][w];
+      }
+      stages += fmt::format(", {} {:.4f}",
+                            candidate(i),
+                            double(before - popcount(reaching)) / sample_count);
+    }
+    fmt::print(stderr,
+               "{}: {:.2f} ns, decided by {}, equal {:.4f}\n",
+               samples[s].name,
+               best.cost[s],
+               stages,
+               double(popcount(reaching)) / sample_count);
+  }
+
+  // the selected moduli must agree with the 64 bit product on the samples
+  for (const auto& s : samples) {
+    for (std::size_t i = 0; i < sample_count; ++i) {
+      const bool expected =
+        std::uint64_t{ s.a[i] } * s.b[i] == std::uint64_t{ s.c[i] } * s.d[i];
+      bool equal = ((s.a[i] * s.b[i]) & first_mask) ==
+                   ((s.c[i] * s.d[i]) & first_mask);
+      for (const auto m : best.moduli) {
+        equal = equal && std::uint64_t{ s.a[i] } * s.b[i] % m ==
+                           std::uint64_t{ s.c[i] } * s.d[i] % m;
+      }
+      if (equal != expected) {
+        fmt::print(stderr, "the selected moduli fail on {} data\n", s.name);
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  const auto text = header(bits, command, best, samples);
+  if (output.empty()) {
+    fmt::print("{}", text);
+  } else {
+    std::FILE* f = std::fopen(output.c_str(), "w");
+    if (f == nullptr) {
+      fmt::print(stderr, "failed opening {}\n", output);
+      return EXIT_FAILURE;
+    }
+    fmt::print(f, "{}", text);
+    std::fclose(f);
+  }
+  return EXIT_SUCCESS;
+}
@@ -1,6 +1,18 @@
 #include <catch2/catch_all.hpp>
 
+#include <batch_products_equal.h>
+#include <divisibility.h>
+#include <montgomery.h>
 #include <multiplication.h>
+#include <products_equal_counters.h>
+#include <runtime_divisor.h>
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstdint>
+#include <random>
+#include <vector>
 
 TEST_CASE("multiply modulo")
 {
@@ -80,3 +92,357 @@ TEST_CASE("hand picked counterexamples")
   static_assert(!products_equal(4291624960, 4291493888, 0, 0));
   static_assert(!products_equal(4291362816, 4291624960, 3598, 0));
 }
+
+#if defined(__SIZEOF_INT128__)
+TEST_CASE("runtime divisor")
+{
+  static_assert(RuntimeDivisor(3).mod(4) == 1);
+  static_assert(RuntimeDivisor(1).mod(UINT_MAX) == 0);
+  static_assert(RuntimeDivisor(65485).mulmod(UINT_MAX, UINT_MAX) ==
+                (std::uint64_t{ UINT_MAX } * UINT_MAX) % 65485);
+  static_assert(RuntimeDivisor(7).divides(0));
+  static_assert(!RuntimeDivisor(7).divides(8));
+
+  std::mt19937 rng;
+  auto check = [&](const std::uint32_t d) {
+    const RuntimeDivisor divisor(d);
+    REQUIRE(divisor.divisor() == d);
+    const std::uint32_t edges[] = {
+      0, 1, d - 1, d, d + 1, 2 * d, UINT_MAX - 1, UINT_MAX
+    };
+    for (const auto x : edges) {
+      REQUIRE(divisor.mod(x) == x % d);
+      REQUIRE(divisor.divides(x) == (x % d == 0));
+      for (const auto y : edges) {
+        REQUIRE(divisor.mulmod(x, y) == (std::uint64_t{ x } * y) % d);
+      }
+    }
+    for (int i = 0; i < 1000; ++i) {
+      const std::uint32_t x = rng();
+      const std::uint32_t y = rng();
+      REQUIRE(divisor.mod(x) == x % d);
+      REQUIRE(divisor.divides(x) == (x % d == 0));
+      REQUIRE(divisor.mulmod(x, y) == (std::uint64_t{ x } * y) % d);
+    }
+  };
+  for (std::uint32_t d = 1; d < 300; ++d) {
+    check(d);
+  }
+  for (const std::uint32_t d :
+       { 65481U, 65483U, 65485U, 65536U, 1U << 31, UINT_MAX - 1, UINT_MAX }) {
+    check(d);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    check(std::max<std::uint32_t>(1, rng()));
+  }
+}
+#endif
+
+TEST_CASE("batch products equal")
+{
+  std::mt19937 rng;
+  for (const std::size_t n : { 0, 1, 7, 63, 64, 65, 1000 }) {
+    std::vector<std::uint32_t> a(n), b(n), c(n), d(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      a[i] = rng();
+      b[i] = rng();
+      switch (i % 4) {
+        case 0:
+          // equal, swapped factors
+          c[i] = b[i];
+          d[i] = a[i];
+          break;
+        case 1:
+          // equal modulo 2**32 only
+          c[i] = a[i] + 1;
+          d[i] = static_cast<std::uint32_t>(std::uint64_t{ a[i] } * b[i]) /
+                 (c[i] | 1);
+          d[i] = a[i] * b[i] == c[i] * d[i] ? d[i] : rng();
+          break;
+        default:
+          c[i] = rng() >> (i % 32);
+          d[i] = rng();
+          break;
+      }
+    }
+    std::vector<std::uint64_t> mask((n + 63) / 64, ~std::uint64_t{});
+    products_equal_batch(a, b, c, d, mask);
+    for (std::size_t i = 0; i < n; ++i) {
+      const bool expected = std::uint64_t{ a[i] } * b[i] ==
+                            std::uint64_t{ c[i] } * d[i];
+      REQUIRE(((mask[i / 64] >> (i % 64)) & 1U) == expected);
+    }
+    if (n % 64 != 0) {
+      REQUIRE(mask.back() >> (n % 64) == 0);
+    }
+  }
+}
+
+TEST_CASE("64 bit products equal")
+{
+  using A2 = std::array<std::uint64_t, 2>;
+  constexpr auto max = ~std::uint64_t{};
+  static_assert(products_equal_crt(A2{ 0, max }, A2{ max, 0 }));
+  static_assert(products_equal_crt(A2{ max, max }, A2{ max, max }));
+  static_assert(!products_equal_crt(A2{ max, max }, A2{ max, max - 1 }));
+  // equal modulo 2**64 only
+  static_assert(!products_equal_crt(A2{ 1ULL << 32, 1ULL << 32 }, A2{ 0, 1 }));
+  static_assert(!products_equal_crt(A2{ max, max }, A2{ 1, 1 }));
+#if defined(__SIZEOF_INT128__)
+  static_assert(products_equal_int128(A2{ 0, max }, A2{ max, 0 }));
+  static_assert(
+    !products_equal_int128(A2{ 1ULL << 32, 1ULL << 32 }, A2{ 0, 1 }));
+  static_assert(!products_equal_int128(A2{ max, max }, A2{ 1, 1 }));
+#endif
+  static_assert(products_equal(std::array<std::uint64_t, 1>{ max },
+                               std::array<std::uint64_t, 1>{ max }));
+}
+
+namespace {
+/// checks all paths on K factors, where lhs and rhs are made from the same
+/// 32 bit pieces in different order so their products are equal
+template<std::size_t K>
+void
+check_n_term_products(std::mt19937_64& rng)
+{
+  std::array<std::uint64_t, 2 * K> pieces;
+  for (auto& p : pieces) {
+    p = static_cast<std::uint32_t>(rng());
+  }
+  std::array<std::uint64_t, K> lhs, rhs;
+  for (std::size_t i = 0; i < K; ++i) {
+    lhs[i] = pieces[2 * i] * pieces[2 * i + 1];
+    rhs[i] = pieces[i] * pieces[2 * K - 1 - i];
+  }
+  REQUIRE(products_equal_crt(lhs, rhs));
+  REQUIRE(products_equal(lhs, rhs));
+
+  // doubles one factor and halves another, which keeps the product only
+  // if the halved factor is even and the doubled one does not overflow
+  auto other = rhs;
+  other[0] <<= 1;
+  other[K - 1] >>= 1;
+  const bool expected = products_equal(lhs, other);
+  REQUIRE(products_equal_crt(lhs, other) == expected);
+
+  // unrelated factors, most likely different
+  for (auto& x : other) {
+    x = rng();
+  }
+  REQUIRE(products_equal_crt(lhs, other) == products_equal(lhs, other));
+#if defined(__SIZEOF_INT128__)
+  if constexpr (K == 2) {
+    __extension__ typedef unsigned __int128 uint128;
+    REQUIRE(products_equal(lhs, other) ==
+            (uint128{ lhs[0] } * lhs[1] == uint128{ other[0] } * other[1]));
+  }
+#endif
+}
+} // namespace
+
+TEST_CASE("n term products equal")
+{
+  std::mt19937_64 rng;
+  for (int i = 0; i < 1000; ++i) {
+    check_n_term_products<1>(rng);
+    check_n_term_products<2>(rng);
+    check_n_term_products<3>(rng);
+    check_n_term_products<4>(rng);
+    check_n_term_products<8>(rng);
+  }
+}
+
+TEST_CASE("branchless products equal and stage counters")
+{
+  static_assert(products_equal_branchless(0, 1, 0, 0));
+  static_assert(!products_equal_branchless(1, 1, 0, 1));
+  static_assert(!products_equal_branchless(
+    4294940936U, 4289265232U, 372413899U, 15529856U));
+  static_assert(!products_equal_branchless(4291624960, 4291493888, 0, 0));
+
+  static_assert(products_equal_deciding_stage(1, 1, 1, 1) ==
+                products_equal_stages);
+  static_assert(products_equal_deciding_stage(1, 1, 0, 1) == 0);
+  // equal modulo 2**32, differs modulo the first of the other moduli
+  static_assert(products_equal_deciding_stage(4291624960, 4291493888, 0, 0) >
+                0);
+
+  std::mt19937 rng;
+  ProductsEqualCounters counters;
+  std::uint64_t equal = 0;
+  for (int i = 0; i < 100000; ++i) {
+    std::uint32_t a = rng();
+    const std::uint32_t b = rng();
+    std::uint32_t c = rng();
+    std::uint32_t d = rng();
+    switch (i % 3) {
+      case 0:
+        c = b;
+        d = a;
+        break;
+      case 1:
+        // c*d - a*b = a*2**31, which is zero modulo 2**32 for even a
+        a &= ~1U;
+        c = a;
+        d = b + (1U << 31);
+        break;
+      default:
+        break;
+    }
+    const bool expected = std::uint64_t{ a } * b == std::uint64_t{ c } * d;
+    equal += expected;
+    REQUIRE(products_equal_branchless(a, b, c, d) == expected);
+    REQUIRE(counters(a, b, c, d) == expected);
+  }
+  REQUIRE(counters.total() == 100000);
+  REQUIRE(counters.count(products_equal_stages) == equal);
+  REQUIRE(counters.count(0) > 0);
+  std::uint64_t past_first = 0;
+  for (std::size_t stage = 1; stage < products_equal_stages; ++stage) {
+    past_first += counters.count(stage);
+  }
+  // the second case
+  REQUIRE(past_first > 30000);
+  REQUIRE(counters.past_first_stage() ==
+          static_cast<double>(past_first + equal) / 100000);
+  counters.reset();
+  REQUIRE(counters.total() == 0);
+}
+
+namespace {
+template<std::uint32_t M>
+void
+check_divisibility(std::mt19937& rng)
+{
+  const std::uint32_t edges[] = {
+    0,         1,        M - 1,        M,        M + 1,
+    2 * M,     3 * M,    UINT_MAX - 1, UINT_MAX, UINT_MAX / M * M,
+  };
+  for (const auto x : edges) {
+    REQUIRE(is_divisible<M>(x) == (x % M == 0));
+  }
+  // multiples and their neighbours, and random values
+  std::vector<std::uint32_t> x;
+  for (int i = 0; i < 2000; ++i) {
+    const auto multiple = static_cast<std::uint32_t>(
+      M * (rng() % (std::uint64_t{ UINT_MAX } / M + 1)));
+    x.push_back(multiple);
+    x.push_back(multiple + 1);
+    x.push_back(multiple - 1);
+    x.push_back(static_cast<std::uint32_t>(rng()));
+  }
+  for (const auto value : x) {
+    REQUIRE(is_divisible<M>(value) == (value % M == 0));
+  }
+
+  for (const std::size_t n : { 0, 1, 63, 64, 65, 1000 }) {
+    const std::span<const std::uint32_t> input(x.data(), n);
+    std::vector<std::uint64_t> mask((n + 63) / 64, ~std::uint64_t{});
+    is_divisible_batch<M>(input, mask);
+    for (std::size_t i = 0; i < n; ++i) {
+      REQUIRE(((mask[i / 64] >> (i % 64)) & 1U) == (x[i] % M == 0));
+    }
+    if (n % 64 != 0) {
+      REQUIRE(mask.back() >> (n % 64) == 0);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("divisibility")
+{
+  static_assert(detail::inverse_modulo_2_32(3) * 3 == 1);
+  static_assert(detail::inverse_modulo_2_32(UINT_MAX) * UINT_MAX == 1);
+  static_assert(is_divisible<3>(0));
+  static_assert(is_divisible<3>(UINT_MAX));
+  static_assert(!is_divisible<3>(UINT_MAX - 1));
+  static_assert(is_divisible<1>(UINT_MAX));
+  static_assert(is_divisible<12>(24));
+  static_assert(!is_divisible<12>(18));
+  static_assert(!is_divisible<12>(4));
+  static_assert(is_divisible<1U << 31>(1U << 31));
+  static_assert(!is_divisible<1U << 31>(1U << 30));
+
+  std::mt19937 rng;
+  check_divisibility<1>(rng);
+  check_divisibility<2>(rng);
+  check_divisibility<3>(rng);
+  check_divisibility<6>(rng);
+  check_divisibility<7>(rng);
+  check_divisibility<12>(rng);
+  check_divisibility<25>(rng);
+  check_divisibility<640>(rng);
+  check_divisibility<65485>(rng);
+  check_divisibility<65536>(rng);
+  check_divisibility<1U << 31>(rng);
+  check_divisibility<4294967291U>(rng);
+  check_divisibility<UINT_MAX>(rng);
+
+  // all values, for a small odd and even divisor
+  for (std::uint64_t x = 0; x <= UINT_MAX; x += 997) {
+    const auto value = static_cast<std::uint32_t>(x);
+    REQUIRE(is_divisible<7>(value) == (value % 7 == 0));
+    REQUIRE(is_divisible<28>(value) == (value % 28 == 0));
+  }
+}
+
+namespace {
+template<std::uint32_t N>
+void
+check_montgomery(std::mt19937& rng)
+{
+  using M = Montgomery<N>;
+  static_assert(N * -M::minus_inverse == 1);
+  static_assert(M::r_squared == (std::uint64_t{ 1 } << 32) % N *
+                                  ((std::uint64_t{ 1 } << 32) % N) % N);
+  const std::uint32_t edges[] = { 0, 1, 2, N - 1, N, N + 1, UINT_MAX };
+  for (const auto x : edges) {
+    REQUIRE(M::from_montgomery(M::to_montgomery(x)) == x % N);
+    for (const auto y : edges) {
+      REQUIRE(multiply_modulo_constant_time<N>(x, y) ==
+              std::uint64_t{ x } * y % N);
+    }
+  }
+  for (int i = 0; i < 10000; ++i) {
+    const std::uint32_t x = rng();
+    const std::uint32_t y = rng();
+    REQUIRE(multiply_modulo_constant_time<N>(x, y) ==
+            std::uint64_t{ x } * y % N);
+  }
+}
+} // namespace
+
+TEST_CASE("constant time products equal")
+{
+  static_assert(multiply_modulo_constant_time<3>(4, 2) == 2);
+  static_assert(multiply_modulo_constant_time<65485>(UINT_MAX, UINT_MAX) ==
+                std::uint64_t{ UINT_MAX } * UINT_MAX % 65485);
+  static_assert(products_equal_constant_time(0, 1, 0, 0));
+  static_assert(!products_equal_constant_time(1, 1, 0, 1));
+  static_assert(!products_equal_constant_time(
+    4294940936U, 4289265232U, 372413899U, 15529856U));
+  static_assert(!products_equal_constant_time(4291624960, 4291493888, 0, 0));
+
+  std::mt19937 rng;
+  check_montgomery<1>(rng);
+  check_montgomery<3>(rng);
+  check_montgomery<65481>(rng);
+  check_montgomery<65485>(rng);
+  check_montgomery<65535>(rng);
+  check_montgomery<(1U << 31) - 1>(rng);
+
+  for (int i = 0; i < 100000; ++i) {
+    std::uint32_t a = rng();
+    const std::uint32_t b = rng();
+    std::uint32_t c = rng();
+    std::uint32_t d = rng();
+    if (i % 2 == 0) {
+      // equal, or equal modulo 2**32 only
+      a &= ~1U;
+      c = a;
+      d = i % 4 == 0 ? b : b + (1U << 31);
+    }
+    REQUIRE(products_equal_constant_time(a, b, c, d) ==
+            (std::uint64_t{ a } * b == std::uint64_t{ c } * d));
+  }
+}
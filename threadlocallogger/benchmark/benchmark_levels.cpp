@@ -0,0 +1,115 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * measures the cost of a log statement that is disabled, either at compile
+ * time by LOGGER_FILE_MIN_LEVEL or at run time by the thread level. the
+ * loops run in a thread for which logging is disabled at run time, so
+ * nothing is written and the difference between the thresholds is the
+ * check itself. prints the time per statement as csv.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "ThreadName.h"
+#include "levels_loop.h"
+
+namespace
+{
+  const char* const level_names[] =
+    { "TRACE", "DEBUG", "INFO", "WARN", "ERROR", "FATAL" };
+
+  /**
+   * @return the best time per iteration in nanoseconds
+   */
+  double
+  measure (LevelLoops::Loop loop, int iterations, int repetitions)
+  {
+    double best = std::numeric_limits<double>::max ();
+    for (int r = 0; r < repetitions; ++r)
+      {
+	const auto start = std::chrono::steady_clock::now ();
+	loop (iterations);
+	const std::chrono::duration<double, std::nano> elapsed =
+	    std::chrono::steady_clock::now () - start;
+	best = std::min (best, elapsed.count () / iterations);
+      }
+    return best;
+  }
+
+  void
+  run (int iterations, int repetitions)
+  {
+    // determineDebugLevel disables logging for this thread
+    ThreadName::setThreadName ("thread 3");
+
+    const LevelLoops* variants[] =
+      { &levels_TRACE, &levels_INFO, &levels_ERROR, &levels_DISABLE_LOGGING };
+    std::printf ("threshold,level,macro,ns_per_statement\n");
+    for (const LevelLoops* v : variants)
+      {
+	for (int level = 0; level < 6; ++level)
+	  {
+	    std::printf ("%s,%s,stream,%.3f\n", v->threshold,
+			 level_names[level],
+			 measure (v->stream[level], iterations, repetitions));
+	    std::printf ("%s,%s,deferred,%.3f\n", v->threshold,
+			 level_names[level],
+			 measure (v->deferred[level], iterations, repetitions));
+	  }
+      }
+  }
+
+  int
+  parse (const char* arg)
+  {
+    std::istringstream iss (arg);
+    int value;
+    if (!(iss >> value) || !iss.eof () || value < 1)
+      {
+	std::fprintf (stderr, "failed parse of %s\n", arg);
+	std::exit (EXIT_FAILURE);
+      }
+    return value;
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  int iterations = 10000000;
+  int repetitions = 5;
+  for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      if (arg == "-n" && i + 1 < argc)
+	{
+	  iterations = parse (argv[++i]);
+	}
+      else if (arg == "-R" && i + 1 < argc)
+	{
+	  repetitions = parse (argv[++i]);
+	}
+      else
+	{
+	  std::fprintf (stderr, "usage: %s [-n iterations] [-R repetitions]\n",
+			argv[0]);
+	  return EXIT_FAILURE;
+	}
+    }
+
+  // in a thread of its own, so the thread name does not affect main
+  std::thread t (run, iterations, repetitions);
+  t.join ();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,336 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * compares the backends of the logger as the number of logging threads
+ * grows: the mutex backend, where log_impl writes to stdout under a lock on
+ * the calling thread, the async backend and the binary mmap sink, with the
+ * stream and the deferred macros each.
+ *
+ * for every combination it measures the time per call of a disabled and an
+ * enabled statement, the total throughput, and the distribution of the time
+ * per enabled call. the latter is timed call by call with steady_clock, so it
+ * includes the cost of reading the clock.
+ *
+ * the log output goes to /dev/null, and the results are written as csv to
+ * the original stdout. the async backend drops records when a ring is full,
+ * and the mmap sink when its file is full, so the number of dropped records
+ * is reported as well, out of the enabled calls of all three passes that
+ * log. the mmap sink writes to a file given with -f.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "ThreadName.h"
+#include "asyncbackend.h"
+#include "binaryformat.h"
+#include "logger.h"
+#include "mmapsink.h"
+
+LOG_INIT();
+
+namespace
+{
+  typedef std::chrono::steady_clock Clock;
+
+  struct StreamMacro
+  {
+    static const char*
+    name ()
+    {
+      return "stream";
+    }
+
+    static void
+    log (int i)
+    {
+      LOG_INFO("iteration " << i << " of the benchmark");
+    }
+  };
+
+  struct DeferredMacro
+  {
+    static const char*
+    name ()
+    {
+      return "deferred";
+    }
+
+    static void
+    log (int i)
+    {
+      LOGF_INFO("iteration {} of the benchmark", i);
+    }
+  };
+
+  double
+  nanoseconds (Clock::duration d)
+  {
+    return std::chrono::duration<double, std::nano> (d).count ();
+  }
+
+  /**
+   * runs body(thread index) on threads that start at the same time. the
+   * threads are named, so their level can be set with setDebugLevel.
+   * @return the wall time in nanoseconds
+   */
+  template <typename Body>
+  double
+  run_threads (int threads, Body body)
+  {
+    std::atomic<int> ready (0);
+    std::atomic<bool> go (false);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+      {
+	pool.emplace_back ([&ready, &go, &body, t]()
+	  {
+	    ThreadName::setThreadName ("bench");
+	    ++ready;
+	    while (!go.load (std::memory_order_acquire))
+	      {
+		std::this_thread::yield ();
+	      }
+	    body (t);
+	  });
+      }
+    while (ready.load () != threads)
+      {
+	std::this_thread::yield ();
+      }
+    const auto start = Clock::now ();
+    go.store (true, std::memory_order_release);
+    for (auto& thread : pool)
+      {
+	thread.join ();
+      }
+    return nanoseconds (Clock::now () - start);
+  }
+
+  void
+  set_level (logger::DebugLevel level)
+  {
+    logger::clearDebugLevels ();
+    logger::setDebugLevel ("bench", "", level);
+  }
+
+  /**
+   * @return the mean time per call, over all threads
+   */
+  template <typename Macro>
+  double
+  time_per_call (int threads, int calls)
+  {
+    std::vector<double> elapsed (threads);
+    run_threads (threads, [&elapsed, calls](int t)
+      {
+	const auto start = Clock::now ();
+	for (int i = 0; i < calls; ++i)
+	  {
+	    Macro::log (i);
+	  }
+	elapsed[t] = nanoseconds (Clock::now () - start);
+      });
+    double sum = 0;
+    for (double e : elapsed)
+      {
+	sum += e;
+      }
+    return sum / threads / calls;
+  }
+
+  double
+  percentile (const std::vector<double>& sorted, double p)
+  {
+    return sorted[static_cast<std::size_t> (p * (sorted.size () - 1))];
+  }
+
+  struct Result
+  {
+    double disabled_ns;
+    double enabled_ns;
+    double records_per_second;
+    double p50_ns;
+    double p99_ns;
+    double p999_ns;
+  };
+
+  template <typename Macro>
+  Result
+  measure (int threads, int calls)
+  {
+    Result r;
+
+    set_level (logger::DebugLevel::ERROR);
+    r.disabled_ns = time_per_call<Macro> (threads, calls);
+
+    set_level (logger::DebugLevel::TRACE);
+    r.enabled_ns = time_per_call<Macro> (threads, calls);
+
+    // again for the throughput, without the per thread clock reads
+    const double wall = run_threads (threads, [calls](int)
+      {
+	for (int i = 0; i < calls; ++i)
+	  {
+	    Macro::log (i);
+	  }
+      });
+    r.records_per_second = 1e9 * threads * calls / wall;
+
+    std::vector<std::vector<double> > samples (threads,
+					       std::vector<double> (calls));
+    run_threads (threads, [&samples, calls](int t)
+      {
+	std::vector<double>& s = samples[t];
+	for (int i = 0; i < calls; ++i)
+	  {
+	    const auto start = Clock::now ();
+	    Macro::log (i);
+	    s[i] = nanoseconds (Clock::now () - start);
+	  }
+      });
+    std::vector<double> all;
+    for (const auto& s : samples)
+      {
+	all.insert (all.end (), s.begin (), s.end ());
+      }
+    std::sort (all.begin (), all.end ());
+    r.p50_ns = percentile (all, 0.5);
+    r.p99_ns = percentile (all, 0.99);
+    r.p999_ns = percentile (all, 0.999);
+    return r;
+  }
+
+  void
+  print (std::FILE* csv, const char* backend, const char* macro, int threads,
+	 int calls, const Result& r, std::uint64_t dropped)
+  {
+    std::fprintf (csv, "%s,%s,%d,%d,%.2f,%.2f,%.0f,%.1f,%.1f,%.1f,%lld,%llu\n",
+		  backend, macro, threads, calls, r.disabled_ns, r.enabled_ns,
+		  r.records_per_second, r.p50_ns, r.p99_ns, r.p999_ns,
+		  3LL * threads * calls,
+		  static_cast<unsigned long long> (dropped));
+    std::fflush (csv);
+  }
+
+  template <typename Macro>
+  void
+  measure_backends (std::FILE* csv, int threads, int calls,
+		    const std::string& file)
+  {
+    print (csv, "mutex", Macro::name (), threads, calls,
+	   measure<Macro> (threads, calls), 0);
+
+    const std::uint64_t dropped_before =
+	logger::AsyncBackend::droppedRecords ();
+    Result r;
+      {
+	logger::AsyncBackend backend;
+	r = measure<Macro> (threads, calls);
+      }
+    print (csv, "async", Macro::name (), threads, calls, r,
+	   logger::AsyncBackend::droppedRecords () - dropped_before);
+
+    // room for every record at its largest, so nothing is dropped. each of
+    // the three passes that log starts new threads, which take chunks of
+    // their own, and the last chunk of each is only partly used. the file
+    // header and the dictionary fit in the first two chunks.
+    const std::size_t chunk = 1 << 20;
+    const std::size_t record = (sizeof(logger::binary::RecordHeader)
+	+ logger::detail::MaxPayload + 7) / 8 * 8;
+    const std::size_t per_chunk = (chunk
+	- sizeof(logger::binary::ChunkHeader)) / record;
+    const std::size_t chunks_per_pass = (calls + per_chunk - 1) / per_chunk;
+    const std::size_t size = 2 * chunk + 3 * threads * chunks_per_pass * chunk;
+    logger::MmapSink sink (file, size, chunk);
+    r = measure<Macro> (threads, calls);
+    print (csv, "mmap", Macro::name (), threads, calls, r,
+	   sink.droppedRecords ());
+  }
+
+  int
+  parse (const char* arg)
+  {
+    std::istringstream iss (arg);
+    int value;
+    if (!(iss >> value) || !iss.eof () || value < 1)
+      {
+	std::fprintf (stderr, "failed parse of %s\n", arg);
+	std::exit (EXIT_FAILURE);
+      }
+    return value;
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  int calls = 100000;
+  int max_threads = std::max (1U, std::thread::hardware_concurrency ());
+  std::string file = "benchmark_threads.tll";
+  for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      if (arg == "-n" && i + 1 < argc)
+	{
+	  calls = parse (argv[++i]);
+	}
+      else if (arg == "-t" && i + 1 < argc)
+	{
+	  max_threads = parse (argv[++i]);
+	}
+      else if (arg == "-f" && i + 1 < argc)
+	{
+	  file = argv[++i];
+	}
+      else
+	{
+	  std::fprintf (stderr,
+			"usage: %s [-n calls per thread] [-t max threads] "
+			"[-f file]\n"
+			"writes csv to stdout. -f is the file of the mmap sink,\n"
+			"default benchmark_threads.tll\n",
+			argv[0]);
+	  return EXIT_FAILURE;
+	}
+    }
+
+  // the csv goes to the original stdout, the log output is thrown away
+  std::FILE* csv = fdopen (dup (STDOUT_FILENO), "w");
+  if (!csv || !std::freopen ("/dev/null", "w", stdout))
+    {
+      std::perror ("redirecting stdout");
+      return EXIT_FAILURE;
+    }
+
+  std::fprintf (csv, "backend,macro,threads,calls_per_thread,disabled_ns,"
+		"enabled_ns,records_per_second,p50_ns,p99_ns,p999_ns,"
+		"enabled_calls,dropped\n");
+  std::vector<int> thread_counts;
+  for (int t = 1; t < max_threads; t *= 2)
+    {
+      thread_counts.push_back (t);
+    }
+  thread_counts.push_back (max_threads);
+  for (int threads : thread_counts)
+    {
+      measure_backends<StreamMacro> (csv, threads, calls, file);
+      measure_backends<DeferredMacro> (csv, threads, calls, file);
+    }
+  std::fclose (csv);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,58 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+// LOGGER_FILE_MIN_LEVEL and LEVELS_VARIANT are set by the build
+#include "logger.h"
+#include "levels_loop.h"
+
+LOG_INIT();
+
+namespace
+{
+  /*
+   * keeps every loop iteration, so a loop whose log statement was removed
+   * is measured as an empty iteration instead of disappearing.
+   */
+  inline void
+  barrier ()
+  {
+    asm volatile ("");
+  }
+
+#define LEVELS_LOOP(name, statement) \
+  void name (int iterations) \
+  { \
+    for (int i = 0; i < iterations; ++i) \
+      { \
+	statement; \
+	barrier (); \
+      } \
+  }
+
+  LEVELS_LOOP(stream_trace, LOG_TRACE("iteration " << i))
+  LEVELS_LOOP(stream_debug, LOG_DEBUG("iteration " << i))
+  LEVELS_LOOP(stream_info, LOG_INFO("iteration " << i))
+  LEVELS_LOOP(stream_warn, LOG_WARN("iteration " << i))
+  LEVELS_LOOP(stream_error, LOG_ERROR("iteration " << i))
+  LEVELS_LOOP(stream_fatal, LOG_FATAL("iteration " << i))
+
+  LEVELS_LOOP(deferred_trace, LOGF_TRACE("iteration {}", i))
+  LEVELS_LOOP(deferred_debug, LOGF_DEBUG("iteration {}", i))
+  LEVELS_LOOP(deferred_info, LOGF_INFO("iteration {}", i))
+  LEVELS_LOOP(deferred_warn, LOGF_WARN("iteration {}", i))
+  LEVELS_LOOP(deferred_error, LOGF_ERROR("iteration {}", i))
+  LEVELS_LOOP(deferred_fatal, LOGF_FATAL("iteration {}", i))
+
+#define LEVELS_STRINGIFY(x) LEVELS_STRINGIFY_IMPL(x)
+#define LEVELS_STRINGIFY_IMPL(x) #x
+}
+
+extern const LevelLoops LEVELS_VARIANT =
+  { LEVELS_STRINGIFY(LOGGER_FILE_MIN_LEVEL),
+    { stream_trace, stream_debug, stream_info, stream_warn, stream_error,
+	stream_fatal },
+    { deferred_trace, deferred_debug, deferred_info, deferred_warn,
+	deferred_error, deferred_fatal } };
@@ -0,0 +1,31 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#ifndef LEVELS_LOOP_H_
+#define LEVELS_LOOP_H_
+
+/*
+ * loops that log once per iteration, at every level and with both the stream
+ * and the deferred macros. levels_loop.cpp is compiled once for each compile
+ * time threshold, giving one LevelLoops object each.
+ */
+struct LevelLoops
+{
+  typedef void
+  (*Loop) (int iterations);
+
+  // the value of LOGGER_FILE_MIN_LEVEL the loops were compiled with
+  const char* threshold;
+  // indexed by DebugLevel, TRACE to FATAL
+  Loop stream[6];
+  Loop deferred[6];
+};
+
+extern const LevelLoops levels_TRACE;
+extern const LevelLoops levels_INFO;
+extern const LevelLoops levels_ERROR;
+extern const LevelLoops levels_DISABLE_LOGGING;
+
+#endif /* LEVELS_LOOP_H_ */
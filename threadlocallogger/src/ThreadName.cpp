@@ -5,6 +5,7 @@
  */
 #include "ThreadName.h"
 
+#include <mutex>
 #include <stdexcept>
 
 #if __linux__
@@ -12,6 +13,28 @@
 #else
 #error please implement me for this platform
 #endif
+
+namespace {
+  // the names of the numbered threads, indexed by number. only touched when
+  // a thread gets its number or its name, never on a per call basis.
+  std::mutex registry_mutex;
+  std::vector<std::string> registry;
+
+  // the number plus one, zero until assigned. plain data, so reading it
+  // needs no thread local initialization check.
+  thread_local unsigned cached_id = 0;
+  thread_local bool name_is_cached = false;
+  thread_local std::string cached_name;
+
+  void
+  publish_name (const std::string& name)
+  {
+    const unsigned id = ThreadName::getThreadId ();
+    std::lock_guard<std::mutex> lock (registry_mutex);
+    registry[id] = name;
+  }
+}
+
 void
 ThreadName::setThreadName (const std::string& name)
 {
@@ -20,18 +43,45 @@ ThreadName::setThreadName (const std::string& name)
       throw std::runtime_error("could not set thread name");
   }
 #endif
+  cached_name = name;
+  name_is_cached = true;
+  publish_name (name);
 }
 
-std::string
+const std::string&
 ThreadName::getThreadName ()
 {
+  if (name_is_cached) {
+      return cached_name;
+  }
 
 #if __linux__
   char name[16];
   if(0!=pthread_getname_np (pthread_self (), name, sizeof(name))) {
       throw std::runtime_error("could not get thread name");
   }
-  return std::string(name);
+  cached_name = name;
+  name_is_cached = true;
+  publish_name (name);
+  return cached_name;
 #endif
 
 }
+
+unsigned
+ThreadName::getThreadId ()
+{
+  if (cached_id == 0) {
+      std::lock_guard<std::mutex> lock (registry_mutex);
+      registry.push_back (std::string ());
+      cached_id = static_cast<unsigned> (registry.size ());
+  }
+  return cached_id - 1;
+}
+
+std::vector<std::string>
+ThreadName::getThreadNames ()
+{
+  std::lock_guard<std::mutex> lock (registry_mutex);
+  return registry;
+}
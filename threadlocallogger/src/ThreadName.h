@@ -6,17 +6,35 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 namespace ThreadName {
   /**
-   * sets the name of the current thread to name.
+   * sets the name of the current thread to name. the name is also kept in
+   * thread local storage, so getThreadName does not need a system call.
    * @param name
    */
   void setThreadName(const std::string& name);
 
   /**
-   * gets the name of the current thread.
+   * gets the name of the current thread. if it was not set with
+   * setThreadName, it is asked for once and then remembered.
    * @return
    */
-  std::string getThreadName();
+  const std::string& getThreadName();
+
+  /**
+   * gets a small number for the current thread, without a system call.
+   * threads are numbered from zero in the order they first ask for their
+   * number or set their name. numbers are not reused when threads exit.
+   * @return
+   */
+  unsigned getThreadId();
+
+  /**
+   * gets the names of all threads that have a number, indexed by the number.
+   * a thread that never set or asked for its name has an empty name.
+   * @return
+   */
+  std::vector<std::string> getThreadNames();
 }
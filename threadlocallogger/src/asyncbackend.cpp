@@ -0,0 +1,303 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "asyncbackend.h"
+#include "ringbuffer.h"
+#include "ThreadName.h"
+
+namespace
+{
+  /*
+   * one log message. it has a fixed size, so appending it is a copy into a
+   * preallocated slot. longer messages are truncated to the length of a
+   * string argument, and written with a trailing "..." to show it. the
+   * mmap sink cuts them the same.
+   *
+   * a record from a deferred log statement has a descriptor, and holds the
+   * encoded arguments instead of the text.
+   */
+  struct Record
+  {
+    enum
+    {
+      MaxText = logger::detail::MaxPayload
+    };
+    const logger::FormatDescriptor* descriptor;
+    const char* file;
+    int line;
+    logger::DebugLevel level;
+    std::uint16_t size;
+    // the text or a string argument was cut
+    bool truncated;
+    char text[MaxText];
+  };
+
+  struct ThreadRing
+  {
+    ThreadRing () :
+	id (ThreadName::getThreadId ()), dropped (0), closed (false),
+	reported_dropped (0)
+    {
+    }
+    RingBuffer<Record, 1024> records;
+    const unsigned id;
+    // records that did not fit, only written by the owning thread
+    std::atomic<std::uint64_t> dropped;
+    // set when the owning thread exits
+    std::atomic<bool> closed;
+    // only used by the flusher
+    std::uint64_t reported_dropped;
+  };
+
+  /*
+   * owns the ring of the current thread, and marks it as closed on thread
+   * exit so the flusher can forget it once it has been drained.
+   */
+  struct RingOwner
+  {
+    ~RingOwner ()
+    {
+      if (ring)
+	{
+	  ring->closed.store (true, std::memory_order_release);
+	}
+    }
+    std::shared_ptr<ThreadRing> ring;
+  };
+
+  thread_local RingOwner ring_owner;
+
+  std::atomic<bool> async_active (false);
+  std::atomic<bool> stop_flusher (false);
+  std::thread flusher;
+  std::atomic<std::uint64_t> total_dropped (0);
+  std::atomic<std::uint64_t> total_truncated (0);
+
+  // all rings not yet drained and forgotten. only locked when a thread logs
+  // for the first time, and by the flusher.
+  std::mutex registry_mutex;
+  std::vector<std::shared_ptr<ThreadRing> > registry;
+
+  ThreadRing*
+  register_thread ()
+  {
+    ring_owner.ring = std::make_shared<ThreadRing> ();
+    std::unique_lock<std::mutex> lock (registry_mutex);
+    registry.push_back (ring_owner.ring);
+    return ring_owner.ring.get ();
+  }
+
+  /**
+   * writes all records in the ring to stdout
+   * @return the number of records written
+   */
+  std::size_t
+  drain (ThreadRing& ring)
+  {
+    std::size_t count = 0;
+    while (const Record* r = ring.records.front ())
+      {
+	std::cout << "threadid=" << ring.id << " level=" << int (r->level)
+	    << " file=" << r->file << " line=" << r->line << ": ";
+	if (r->descriptor)
+	  {
+	    logger::format_deferred (
+		std::cout, *r->descriptor,
+		reinterpret_cast<const unsigned char*> (r->text), r->size);
+	  }
+	else
+	  {
+	    std::cout.write (r->text, r->size);
+	  }
+	if (r->truncated)
+	  {
+	    // a cut string argument is marked by format_deferred
+	    if (!r->descriptor)
+	      {
+		std::cout << "...";
+	      }
+	    total_truncated.fetch_add (1, std::memory_order_relaxed);
+	  }
+	std::cout << '\n';
+	ring.records.pop ();
+	++count;
+      }
+    const std::uint64_t dropped = ring.dropped.load (std::memory_order_relaxed);
+    if (dropped != ring.reported_dropped)
+      {
+	std::cout << "threadid=" << ring.id << " dropped "
+	    << dropped - ring.reported_dropped << " records\n";
+	total_dropped.fetch_add (dropped - ring.reported_dropped,
+				 std::memory_order_relaxed);
+	ring.reported_dropped = dropped;
+      }
+    return count;
+  }
+
+  void
+  flush_loop ()
+  {
+    std::vector<std::shared_ptr<ThreadRing> > rings;
+    for (;;)
+      {
+	// read before draining, so everything logged before the stop request
+	// is written out by the last round
+	const bool stopping = stop_flusher.load (std::memory_order_acquire);
+	  {
+	    std::unique_lock<std::mutex> lock (registry_mutex);
+	    rings = registry;
+	  }
+	std::size_t written = 0;
+	std::vector<ThreadRing*> finished;
+	for (const auto& ring : rings)
+	  {
+	    const bool closed = ring->closed.load (std::memory_order_acquire);
+	    written += drain (*ring);
+	    if (closed)
+	      {
+		finished.push_back (ring.get ());
+	      }
+	  }
+	if (!finished.empty ())
+	  {
+	    std::unique_lock<std::mutex> lock (registry_mutex);
+	    registry.erase (
+		std::remove_if (registry.begin (), registry.end (),
+				[&finished](const std::shared_ptr<ThreadRing>& r)
+				  { return std::find (finished.begin (), finished.end (),
+						      r.get ()) != finished.end ();}),
+		registry.end ());
+	  }
+	if (stopping)
+	  {
+	    break;
+	  }
+	if (written == 0)
+	  {
+	    std::cout.flush ();
+	    std::this_thread::sleep_for (std::chrono::milliseconds (1));
+	  }
+      }
+    std::cout.flush ();
+  }
+}
+
+logger::AsyncBackend::AsyncBackend ()
+{
+  if (async_active.load ())
+    {
+      throw std::logic_error ("there can only be one AsyncBackend");
+    }
+  stop_flusher.store (false);
+  flusher = std::thread (flush_loop);
+  async_active.store (true, std::memory_order_release);
+}
+
+logger::AsyncBackend::~AsyncBackend ()
+{
+  async_active.store (false, std::memory_order_release);
+  stop_flusher.store (true, std::memory_order_release);
+  flusher.join ();
+}
+
+namespace
+{
+  /**
+   * a slot in the ring of the calling thread, or nullptr if the ring is full
+   * (the record is counted as dropped) or there is no async backend.
+   * active tells which.
+   */
+  Record*
+  reserve_record (ThreadRing*& ring, bool& active)
+  {
+    active = async_active.load (std::memory_order_acquire);
+    if (!active)
+      {
+	return nullptr;
+      }
+    ring = ring_owner.ring.get ();
+    if (!ring)
+      {
+	ring = register_thread ();
+      }
+    Record* r = ring->records.reserve ();
+    if (!r)
+      {
+	ring->dropped.store (ring->dropped.load (std::memory_order_relaxed) + 1,
+			     std::memory_order_relaxed);
+      }
+    return r;
+  }
+}
+
+std::uint64_t
+logger::AsyncBackend::droppedRecords ()
+{
+  return total_dropped.load (std::memory_order_relaxed);
+}
+
+std::uint64_t
+logger::AsyncBackend::truncatedRecords ()
+{
+  return total_truncated.load (std::memory_order_relaxed);
+}
+
+bool
+logger::detail::async_log (DebugLevel level, const char* file, int line,
+			   const std::string& what)
+{
+  ThreadRing* ring;
+  bool active;
+  Record* r = reserve_record (ring, active);
+  if (!r)
+    {
+      return active;
+    }
+  r->descriptor = nullptr;
+  r->file = file;
+  r->line = line;
+  r->level = level;
+  r->size = static_cast<std::uint16_t> (
+      std::min<std::size_t> (what.size (), logger::detail::MaxString));
+  r->truncated = what.size () > logger::detail::MaxString;
+  std::memcpy (r->text, what.data (), r->size);
+  ring->records.push ();
+  return true;
+}
+
+bool
+logger::detail::async_log_deferred (const FormatDescriptor* descriptor,
+				    const unsigned char* args, std::size_t size,
+				    bool cut)
+{
+  ThreadRing* ring;
+  bool active;
+  Record* r = reserve_record (ring, active);
+  if (!r)
+    {
+      return active;
+    }
+  r->descriptor = descriptor;
+  r->file = descriptor->file;
+  r->line = descriptor->line;
+  r->level = descriptor->level;
+  r->size = static_cast<std::uint16_t> (size);
+  r->truncated = cut;
+  std::memcpy (r->text, args, size);
+  ring->records.push ();
+  return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#ifndef ASYNCBACKEND_H_
+#define ASYNCBACKEND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "logger.h"
+
+namespace logger
+{
+  /*
+   * while an object of this class exists, log_impl does not write to stdout
+   * itself. instead, each thread appends its records to a ring buffer of its
+   * own, and a single background thread drains all rings and writes them.
+   * the logging thread only takes a lock the first time it logs, to register
+   * its ring. if a ring is full, the record is dropped and counted instead of
+   * blocking the caller. messages longer than the records hold are cut,
+   * and written with a trailing "...".
+   *
+   * records from one thread keep their order, records from different threads
+   * may be interleaved differently than they were logged.
+   *
+   * create it in main before starting other threads, and destroy it after
+   * they have been joined. the destructor writes out everything still in the
+   * rings.
+   */
+  class AsyncBackend
+  {
+  public:
+    AsyncBackend ();
+    ~AsyncBackend ();
+
+    /**
+     * @return the number of records dropped because a ring was full, since
+     * the program started. counted by the flusher, so it is complete once
+     * the backend has been destroyed.
+     */
+    static std::uint64_t
+    droppedRecords ();
+
+    /**
+     * @return the number of records whose text or a string argument was cut
+     * because it did not fit, since the program started. counted like
+     * droppedRecords.
+     */
+    static std::uint64_t
+    truncatedRecords ();
+
+    AsyncBackend (const AsyncBackend&) = delete;
+    AsyncBackend&
+    operator= (const AsyncBackend&) = delete;
+  };
+
+  namespace detail
+  {
+    /**
+     * appends a record to the ring of the calling thread
+     * @return false if there is no async backend, and the caller has to
+     * write the record itself
+     */
+    bool
+    async_log (DebugLevel level, const char* file, int line,
+	       const std::string& what);
+
+    /**
+     * same as async_log, for a deferred log statement
+     * @param cut true if a string argument was cut, which is counted
+     */
+    bool
+    async_log_deferred (const FormatDescriptor* descriptor,
+			const unsigned char* args, std::size_t size, bool cut);
+  }
+}
+
+#endif /* ASYNCBACKEND_H_ */
@@ -0,0 +1,115 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#ifndef BINARYFORMAT_H_
+#define BINARYFORMAT_H_
+
+#include <cstdint>
+
+/*
+ * the layout of the files written by MmapSink and read by tlldecode. all
+ * integers are in the byte order of the machine that wrote the file.
+ *
+ * the file starts with a FileHeader, followed by the dictionary and then
+ * the chunks. the dictionary holds a DictionaryEntry for every log statement
+ * (site) and every thread, and the chunks hold the records. each thread
+ * writes to a chunk of its own and takes a new one when it is full.
+ *
+ * a record is a RecordHeader followed by the arguments, encoded as in
+ * deferred.h. the text of a stream statement is stored as one string
+ * argument.
+ */
+
+namespace logger
+{
+  namespace binary
+  {
+    const char magic[8] =
+      { 'T', 'L', 'L', 'O', 'G', 'B', 'I', 'N' };
+    const std::uint32_t format_version = 2;
+
+    enum Clock
+    {
+      // nanoseconds of steady_clock
+      SteadyClock = 0,
+      // time stamp counter ticks, converted with the calibration fields
+      TimeStampCounter = 1
+    };
+
+    struct FileHeader
+    {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t clock;
+      std::uint64_t file_size;
+      std::uint64_t dictionary_offset;
+      std::uint64_t dictionary_capacity;
+      std::uint64_t chunks_offset;
+      std::uint64_t chunk_size;
+      std::uint64_t chunk_count;
+      // the clock and steady_clock nanoseconds when the file was opened and
+      // closed, to convert time stamp counter ticks to time
+      std::uint64_t start_ticks;
+      std::uint64_t start_ns;
+      std::uint64_t stop_ticks;
+      std::uint64_t stop_ns;
+      // system_clock nanoseconds since the epoch when the file was opened
+      std::uint64_t start_unix_ns;
+
+      // the fields below change while logging, and are published with
+      // release stores
+      std::uint64_t dictionary_used;
+      std::uint64_t chunks_used;
+      std::uint64_t dropped_records;
+      // nonzero once the file was closed
+      std::uint64_t closed;
+    };
+
+    /*
+     * a site entry is followed by the zero terminated file, format and
+     * types. a thread entry is followed by the zero terminated thread id,
+     * as written by the text backends, the thread name and an empty string.
+     */
+    struct DictionaryEntry
+    {
+      enum Kind
+      {
+	Site = 'S', Thread = 'T'
+      };
+      std::uint32_t kind;
+      // the site or thread id
+      std::uint32_t id;
+      // for sites
+      std::uint32_t level;
+      std::int32_t line;
+    };
+
+    struct ChunkHeader
+    {
+      std::uint32_t thread;
+      std::uint32_t reserved;
+      // bytes of records after the header, published with a release store
+      std::uint64_t used;
+    };
+
+    struct RecordHeader
+    {
+      std::uint64_t timestamp;
+      std::uint32_t site;
+      // ThreadName::getThreadId, modulo 2**16
+      std::uint16_t thread;
+      // the size of the arguments, with Cut set if a string argument was
+      // cut. the cut string itself is marked as in deferred.h.
+      std::uint16_t size;
+
+      enum
+      {
+	Cut = 0x8000
+      };
+    };
+  }
+}
+
+#endif /* BINARYFORMAT_H_ */
@@ -0,0 +1,135 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#include "deferred.h"
+
+namespace
+{
+  /*
+   * reads encoded arguments. it does not trust the size, so a truncated or
+   * corrupt record gives a marker in the output instead of a crash.
+   */
+  class Decoder
+  {
+  public:
+    Decoder (const unsigned char* begin, std::size_t size) :
+	m_p (begin), m_end (begin + size)
+    {
+    }
+
+    /**
+     * writes the next argument
+     * @return false if there was not enough data
+     */
+    bool
+    write (std::ostream& os, char type)
+    {
+      switch (type)
+	{
+	case 'b':
+	  {
+	    unsigned char x;
+	    return read (x) && (os << bool (x));
+	  }
+	case 'c':
+	  {
+	    char x;
+	    return read (x) && (os << x);
+	  }
+	case 'i':
+	  {
+	    std::int64_t x;
+	    return read (x) && (os << x);
+	  }
+	case 'u':
+	  {
+	    std::uint64_t x;
+	    return read (x) && (os << x);
+	  }
+	case 'd':
+	  {
+	    double x;
+	    return read (x) && (os << x);
+	  }
+	case 'p':
+	  {
+	    std::uint64_t x;
+	    return read (x) && (os << reinterpret_cast<const void*> (
+				static_cast<std::uintptr_t> (x)));
+	  }
+	case 's':
+	  {
+	    std::uint16_t prefix;
+	    if (!read (prefix))
+	      {
+		return false;
+	      }
+	    const std::size_t n = prefix & ~logger::detail::StringCut;
+	    if (n > std::size_t (m_end - m_p))
+	      {
+		return false;
+	      }
+	    os.write (reinterpret_cast<const char*> (m_p), n);
+	    m_p += n;
+	    if (prefix & logger::detail::StringCut)
+	      {
+		os << "...";
+	      }
+	    return true;
+	  }
+	default:
+	  return false;
+	}
+    }
+
+  private:
+    template <typename T>
+    bool
+    read (T& x)
+    {
+      if (sizeof(T) > std::size_t (m_end - m_p))
+	{
+	  return false;
+	}
+      std::memcpy (&x, m_p, sizeof(T));
+      m_p += sizeof(T);
+      return true;
+    }
+
+    const unsigned char* m_p;
+    const unsigned char* m_end;
+  };
+}
+
+void
+logger::format_deferred (std::ostream& os, const FormatDescriptor& descriptor,
+			 const unsigned char* args, std::size_t size)
+{
+  Decoder decoder (args, size);
+  const char* type = descriptor.types;
+  bool ok = true;
+  for (const char* f = descriptor.format; *f; ++f)
+    {
+      if (ok && f[0] == '{' && f[1] == '}' && *type)
+	{
+	  ok = decoder.write (os, *type++);
+	  ++f;
+	}
+      else
+	{
+	  os.put (*f);
+	}
+    }
+  // arguments without a placeholder are appended
+  while (ok && *type)
+    {
+      os.put (' ');
+      ok = decoder.write (os, *type++);
+    }
+  if (!ok)
+    {
+      os << " [corrupt arguments]";
+    }
+}
@@ -0,0 +1,351 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#ifndef DEFERRED_H_
+#define DEFERRED_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+/*
+ * deferred formatting. instead of formatting the message on the logging
+ * thread, the call site keeps a static descriptor with the format string and
+ * the argument types, and only the raw bytes of the arguments are copied
+ * into the record. the text is produced later by whoever writes it out.
+ *
+ * the format string uses {} as placeholder for the next argument, which is
+ * written as if with operator<<. supported arguments are bool, char,
+ * integers, floating point, strings and pointers.
+ */
+
+namespace logger
+{
+  enum class DebugLevel;
+
+  /*
+   * everything about a log statement that is known at compile time.
+   */
+  struct FormatDescriptor
+  {
+    DebugLevel level;
+    const char* file;
+    int line;
+    const char* format;
+    // one type code per argument, see TypeCode
+    const char* types;
+    // assigned the first time a binary sink sees the statement, zero before
+    mutable std::atomic<std::uint32_t> id;
+  };
+
+  /**
+   * writes the message described by the descriptor and the encoded arguments
+   */
+  void
+  format_deferred (std::ostream& os, const FormatDescriptor& descriptor,
+		   const unsigned char* args, std::size_t size);
+
+  namespace detail
+  {
+    enum
+    {
+      // the largest size of the encoded arguments of one record
+      MaxPayload = 224,
+      // the longest string that fits, after its length
+      MaxString = MaxPayload - 2,
+      // set in the length of a string that was cut to fit
+      StringCut = 0x8000
+    };
+
+    /*
+     * how an argument type is encoded. integers are widened to 64 bits and
+     * strings are stored as a 16 bit length followed by the characters, with
+     * StringCut set in the length if the string did not fit. size is the
+     * fixed part of the encoding.
+     */
+    template <typename T, typename Enable = void>
+    struct TypeCode;
+
+    template <>
+    struct TypeCode<bool>
+    {
+      static const char value = 'b';
+      static const std::size_t size = 1;
+    };
+
+    template <>
+    struct TypeCode<char>
+    {
+      static const char value = 'c';
+      static const std::size_t size = 1;
+    };
+
+    template <typename T>
+    struct TypeCode<T,
+	typename std::enable_if<std::is_integral<T>::value
+	    && std::is_signed<T>::value>::type>
+    {
+      static const char value = 'i';
+      static const std::size_t size = 8;
+    };
+
+    template <typename T>
+    struct TypeCode<T,
+	typename std::enable_if<std::is_integral<T>::value
+	    && std::is_unsigned<T>::value>::type>
+    {
+      static const char value = 'u';
+      static const std::size_t size = 8;
+    };
+
+    template <typename T>
+    struct TypeCode<T,
+	typename std::enable_if<std::is_floating_point<T>::value>::type>
+    {
+      static const char value = 'd';
+      static const std::size_t size = 8;
+    };
+
+    template <typename T>
+    struct TypeCode<T*>
+    {
+      static const char value = 'p';
+      static const std::size_t size = 8;
+    };
+
+    template <>
+    struct TypeCode<const char*>
+    {
+      static const char value = 's';
+      static const std::size_t size = 2;
+    };
+
+    template <>
+    struct TypeCode<char*> : TypeCode<const char*>
+    {
+    };
+
+    template <>
+    struct TypeCode<std::string> : TypeCode<const char*>
+    {
+    };
+
+    template <typename ... Args>
+    struct Signature
+    {
+      static const char value[sizeof...(Args) + 1];
+    };
+
+    template <typename ... Args>
+    const char Signature<Args...>::value[sizeof...(Args) + 1] =
+      { TypeCode<Args>::value..., '\0' };
+
+    /**
+     * only used in decltype, to get the signature of the arguments to a log
+     * statement without evaluating them
+     */
+    template <typename ... Args>
+    Signature<typename std::decay<Args>::type...>
+    signature_of (const char* format, const Args&... args);
+
+    template <typename ... Args>
+    struct FixedSize;
+
+    template <>
+    struct FixedSize<>
+    {
+      static const std::size_t value = 0;
+    };
+
+    template <typename T, typename ... Rest>
+    struct FixedSize<T, Rest...>
+    {
+      static const std::size_t value = TypeCode<T>::size
+	  + FixedSize<Rest...>::value;
+    };
+
+    /*
+     * encodes arguments into a fixed size buffer. strings are truncated to
+     * what fits after the other arguments, and marked with StringCut, so
+     * they are written with a trailing "...".
+     */
+    class Encoder
+    {
+    public:
+      explicit
+      Encoder (std::size_t reserved) :
+	  m_size (0), m_reserved (reserved), m_cut (false)
+      {
+      }
+
+      void
+      put (bool value)
+      {
+	const unsigned char c = value;
+	raw (&c, 1);
+      }
+
+      void
+      put (char value)
+      {
+	raw (&value, 1);
+      }
+
+      template <typename T>
+      typename std::enable_if<std::is_integral<T>::value
+	  && std::is_signed<T>::value>::type
+      put (T value)
+      {
+	const std::int64_t x = value;
+	raw (&x, sizeof (x));
+      }
+
+      template <typename T>
+      typename std::enable_if<std::is_integral<T>::value
+	  && std::is_unsigned<T>::value>::type
+      put (T value)
+      {
+	const std::uint64_t x = value;
+	raw (&x, sizeof (x));
+      }
+
+      template <typename T>
+      typename std::enable_if<std::is_floating_point<T>::value>::type
+      put (T value)
+      {
+	const double x = value;
+	raw (&x, sizeof (x));
+      }
+
+      template <typename T>
+      void
+      put (const T* value)
+      {
+	const std::uint64_t x = reinterpret_cast<std::uintptr_t> (value);
+	raw (&x, sizeof (x));
+      }
+
+      void
+      put (const char* value)
+      {
+	// a null pointer is written as an empty string
+	if (!value)
+	  {
+	    value = "";
+	  }
+	string (value, std::strlen (value));
+      }
+
+      void
+      put (char* value)
+      {
+	put (static_cast<const char*> (value));
+      }
+
+      void
+      put (const std::string& value)
+      {
+	string (value.data (), value.size ());
+      }
+
+      const unsigned char*
+      data () const
+      {
+	return m_data;
+      }
+
+      std::size_t
+      size () const
+      {
+	return m_size;
+      }
+
+      /**
+       * @return true if a string was cut
+       */
+      bool
+      cut () const
+      {
+	return m_cut;
+      }
+
+    private:
+      void
+      raw (const void* p, std::size_t n)
+      {
+	std::memcpy (m_data + m_size, p, n);
+	m_size += n;
+	m_reserved -= n;
+      }
+
+      void
+      string (const char* s, std::size_t length)
+      {
+	// the length prefix is already accounted for in m_reserved
+	const std::size_t available = MaxPayload - m_size - m_reserved;
+	const std::uint16_t n =
+	    static_cast<std::uint16_t> (length < available ? length : available);
+	if (n < length)
+	  {
+	    m_cut = true;
+	  }
+	const std::uint16_t prefix = n | (n < length ? StringCut : 0);
+	raw (&prefix, sizeof (prefix));
+	std::memcpy (m_data + m_size, s, n);
+	m_size += n;
+      }
+
+      unsigned char m_data[MaxPayload];
+      std::size_t m_size;
+      // bytes needed by the fixed part of the arguments not yet encoded
+      std::size_t m_reserved;
+      bool m_cut;
+    };
+
+    inline void
+    encode (Encoder&)
+    {
+    }
+
+    template <typename T, typename ... Rest>
+    void
+    encode (Encoder& encoder, const T& first, const Rest&... rest)
+    {
+      encoder.put (first);
+      encode (encoder, rest...);
+    }
+
+    /**
+     * appends the record to the binary sink or the async backend, or formats
+     * and writes it directly if there is neither
+     * @param cut true if a string argument was cut, so the backends can
+     * count it
+     */
+    void
+    log_deferred_impl (const FormatDescriptor* descriptor,
+		       const unsigned char* args, std::size_t size, bool cut);
+  }
+
+  template <typename ... Args>
+  void
+  log_deferred (const FormatDescriptor* descriptor, const char* /*format*/,
+		const Args&... args)
+  {
+    static const std::size_t fixed = detail::FixedSize<
+	typename std::decay<Args>::type...>::value;
+    static_assert(fixed <= detail::MaxPayload,
+	"too many arguments to a deferred log statement");
+    detail::Encoder encoder (fixed);
+    detail::encode (encoder, args...);
+    detail::log_deferred_impl (descriptor, encoder.data (), encoder.size (),
+			       encoder.cut ());
+  }
+}
+
+#endif /* DEFERRED_H_ */
@@ -6,43 +6,195 @@
 #ifndef LOGGER_CPP_
 #define LOGGER_CPP_
 
+#include <cstddef>
 #include <iostream>
 #include <mutex>
-#include <thread>
+#include <vector>
 
 #include "logger.h"
+#include "asyncbackend.h"
+#include "mmapsink.h"
 #include "ThreadName.h"
 
 namespace
 {
   std::mutex logger_stdout_mutex;
+
+  struct LevelSetting
+  {
+    std::string thread;
+    std::string file;
+    logger::DebugLevel level;
+  };
+
+  // the settings from setDebugLevel. only used when a thread refreshes its
+  // levels, so a mutex is fine.
+  std::mutex settings_mutex;
+  std::vector<LevelSetting> settings;
+
+  bool
+  ends_with (const char* s, const std::string& suffix)
+  {
+    const std::size_t n = std::char_traits<char>::length (s);
+    return n >= suffix.size ()
+	&& suffix.compare (0, suffix.size (), s + n - suffix.size ()) == 0;
+  }
+
+  /**
+   * @param level set to the best matching setting, if any
+   * @return true if a setting matched
+   */
+  bool
+  find_setting (const std::string& thread, const char* file,
+		logger::DebugLevel& level)
+  {
+    std::unique_lock<std::mutex> lock (settings_mutex);
+    int best = 0;
+    for (const auto& s : settings)
+      {
+	const bool thread_match = s.thread.empty () || s.thread == thread;
+	const bool file_match = s.file.empty () || ends_with (file, s.file);
+	if (!thread_match || !file_match)
+	  {
+	    continue;
+	  }
+	// later settings replace earlier ones of the same precedence
+	const int precedence = 1 + 2 * !s.thread.empty () + !s.file.empty ();
+	if (precedence >= best)
+	  {
+	    best = precedence;
+	    level = s.level;
+	  }
+      }
+    return best > 0;
+  }
+
+  void
+  publish_settings ()
+  {
+    // after the settings were written, so a thread that sees the new
+    // version and locks the mutex sees them too
+    logger::detail::config_version.fetch_add (1, std::memory_order_release);
+  }
+}
+
+std::atomic<unsigned> logger::detail::config_version (0);
+
+void
+logger::setDebugLevel (const std::string& thread, const std::string& file,
+		       DebugLevel level)
+{
+    {
+      std::unique_lock<std::mutex> lock (settings_mutex);
+      LevelSetting s;
+      s.thread = thread;
+      s.file = file;
+      s.level = level;
+      settings.push_back (s);
+    }
+  publish_settings ();
+}
+
+void
+logger::clearDebugLevels ()
+{
+    {
+      std::unique_lock<std::mutex> lock (settings_mutex);
+      settings.clear ();
+    }
+  publish_settings ();
+}
+
+void
+logger::ThreadLevel::refresh ()
+{
+  // acquire, so the settings written before this version are visible
+  m_version = detail::config_version.load (std::memory_order_acquire);
+  m_level = determineDebugLevel (m_file);
 }
 
 void
 logger::log_impl (DebugLevel level, const char* file, int line,
 		  const std::string& what)
 {
+  if (detail::async_log (level, file, line, what))
+    {
+      return;
+    }
+
+  const unsigned id = ThreadName::getThreadId ();
   std::unique_lock<std::mutex> lock (logger_stdout_mutex);
-  const auto id = std::this_thread::get_id ();
 
   std::cout << "threadid=" << id << " level=" << int (level) << " file=" << file
       << " line=" << line << ": " << what << '\n';
 }
 
+void
+logger::detail::log_text (const FormatDescriptor* descriptor,
+			  const std::string& what)
+{
+  if (mmap_sink_active ())
+    {
+      // the text is stored as the single string argument of the site
+      Encoder encoder (TypeCode<std::string>::size);
+      encoder.put (what);
+      if (mmap_log (descriptor, encoder.data (), encoder.size (),
+		    encoder.cut ()))
+	{
+	  return;
+	}
+    }
+  log_impl (descriptor->level, descriptor->file, descriptor->line, what);
+}
+
+void
+logger::logThreadNames ()
+{
+  static const FormatDescriptor descriptor =
+    { DebugLevel::INFO, __FILE__, __LINE__, "thread {} is named {}", "us", {} };
+  const std::vector<std::string> names = ThreadName::getThreadNames ();
+  for (std::size_t id = 0; id < names.size (); ++id)
+    {
+      log_deferred (&descriptor, descriptor.format, id, names[id]);
+    }
+}
+
+void
+logger::detail::log_deferred_impl (const FormatDescriptor* descriptor,
+				   const unsigned char* args, std::size_t size,
+				   bool cut)
+{
+  if (mmap_log (descriptor, args, size, cut)
+      || async_log_deferred (descriptor, args, size, cut))
+    {
+      return;
+    }
+
+  std::ostringstream oss;
+  format_deferred (oss, *descriptor, args, size);
+  log_impl (descriptor->level, descriptor->file, descriptor->line, oss.str ());
+}
+
 /*
  * note - this is just a crude sketch showing how the debug level can be set
  * depending on the thread. it could just as well use the file, or query some
- * config file. it could be generalized to let the user set a callback somewhere
+ * config file. it could be generalized to let the user set a callback somewhere.
+ * settings made with setDebugLevel take precedence.
  */
 logger::DebugLevel
 logger::determineDebugLevel (const char* file)
 {
 
   //get the thread name
-  const std::string name = ThreadName::getThreadName ();
+  const std::string& name = ThreadName::getThreadName ();
 
   logger::DebugLevel result = DebugLevel::DISABLE_LOGGING;
 
+  if (find_setting (name, file, result))
+    {
+      return result;
+    }
+
   if (name == "thread 1")
     {
       result = DebugLevel::TRACE;
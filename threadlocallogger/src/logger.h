@@ -6,13 +6,18 @@
 #ifndef LOGGER_H_
 #define LOGGER_H_
 
+#include <atomic>
 #include <sstream>
+#include <string>
+
+#include "deferred.h"
 
 /*
  * this is a basic sketch for a logger that is meant to
  * * know the source file name and line number
- * * debug level configurable at compile time, or
- * * debug level set during program initialization but not later.
+ * * debug level configurable at compile time (see LOGGER_MIN_LEVEL), or
+ * * debug level set during program initialization, and changed later with
+ *   setDebugLevel.
  * * select debug level depending on combination of thread and source file, to
  *   be able to for instance follow one specific thread very closely, ignoring
  *   the others.
@@ -39,8 +44,9 @@ namespace logger
    * this function is meant to be called after the logging has been fully
    * configured in the main thread, before other threads have started.
    * it does not need to be fast, because it is only called during
-   * initialization. it will return it answer depending on the file name and the
-   * thread id (it must be called from the thread it asks for)
+   * initialization and after the settings changed. it will return it answer
+   * depending on the file name and the thread id (it must be called from the
+   * thread it asks for)
    *
    * @param file file name
    * @return the level for the current thread and source file. debug messages of
@@ -49,7 +55,102 @@ namespace logger
    */
   DebugLevel
   determineDebugLevel (const char* file);
+
+  /**
+   * changes the level of the threads with the given name, for the source
+   * files ending with file. an empty thread name or file matches all. when
+   * several settings match, the one with both thread and file wins over the
+   * one with only the thread, which wins over the one with only the file.
+   * settings are checked by determineDebugLevel, before its defaults.
+   *
+   * this may be called at any time. running threads pick up the change the
+   * next time they reach a log statement.
+   */
+  void
+  setDebugLevel (const std::string& thread, const std::string& file,
+		 DebugLevel level);
+
+  /**
+   * removes all settings made with setDebugLevel
+   */
+  void
+  clearDebugLevels ();
+
+  /**
+   * writes the number and name of every thread known to ThreadName, one
+   * record each, regardless of the levels. the records only carry the thread
+   * number, so this is meant to be called once the threads are named, to be
+   * able to tell them apart in the log.
+   */
+  void
+  logThreadNames ();
+
+  namespace detail
+  {
+    /**
+     * writes the text of a stream statement to the binary sink, the async
+     * backend or stdout, whichever is active
+     */
+    void
+    log_text (const FormatDescriptor* descriptor, const std::string& what);
+
+    // incremented after every change of the settings
+    extern std::atomic<unsigned> config_version;
+  }
+
+  /*
+   * the level of one thread for one source file. it caches the answer from
+   * determineDebugLevel, together with the settings version it was computed
+   * for, so checking it costs one relaxed load and a compare until the
+   * settings change.
+   */
+  class ThreadLevel
+  {
+  public:
+    explicit
+    ThreadLevel (const char* file) :
+	m_file (file), m_version (0), m_level (DebugLevel::DISABLE_LOGGING)
+    {
+      refresh ();
+    }
+
+    DebugLevel
+    get ()
+    {
+      if (detail::config_version.load (std::memory_order_relaxed) != m_version)
+	{
+	  refresh ();
+	}
+      return m_level;
+    }
+
+  private:
+    void
+    refresh ();
+
+    const char* m_file;
+    unsigned m_version;
+    DebugLevel m_level;
+  };
 }
+
+/*
+ * compile time thresholds. statements below the level are removed by the
+ * compiler, so they cost nothing, not even the thread local lookup.
+ * LOGGER_MIN_LEVEL applies to the whole program and is meant to be set on
+ * the command line, like -DLOGGER_MIN_LEVEL=INFO. LOGGER_FILE_MIN_LEVEL can
+ * be defined before including this header to raise the threshold for one
+ * translation unit. the arguments are still compiled, so they do not rot.
+ */
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL TRACE
+#endif
+#ifndef LOGGER_FILE_MIN_LEVEL
+#define LOGGER_FILE_MIN_LEVEL TRACE
+#endif
+#define LOGGER_COMPILED_IN(level) \
+	(level>=logger::DebugLevel::LOGGER_MIN_LEVEL && \
+	 level>=logger::DebugLevel::LOGGER_FILE_MIN_LEVEL)
 #define LOG_TRACE(...) LOG_IMPL(logger::DebugLevel::TRACE, __FILE__, __LINE__, __VA_ARGS__)
 #define LOG_DEBUG(...) LOG_IMPL(logger::DebugLevel::DEBUG, __FILE__, __LINE__, __VA_ARGS__)
 #define LOG_INFO(...)  LOG_IMPL(logger::DebugLevel::INFO,  __FILE__, __LINE__, __VA_ARGS__)
@@ -57,10 +158,32 @@ namespace logger
 #define LOG_ERROR(...) LOG_IMPL(logger::DebugLevel::ERROR, __FILE__, __LINE__, __VA_ARGS__)
 #define LOG_FATAL(...) LOG_IMPL(logger::DebugLevel::FATAL, __FILE__, __LINE__, __VA_ARGS__)
 #define LOG_IMPL(level,file,line,...) \
-	if(level>=thread_specific_debuglevel) { \
+	if(LOGGER_COMPILED_IN(level) && level>=thread_specific_debuglevel.get()) { \
+		static const logger::FormatDescriptor logger_format_descriptor = { \
+		    level, file, line, "{}", "s", {} }; \
 		std::ostringstream oss; oss<<__VA_ARGS__; \
-		log_impl(level,file,line,oss.str()); \
+		logger::detail::log_text(&logger_format_descriptor, oss.str()); \
+	    }
+
+/*
+ * deferred variants, which take a format string literal with {} placeholders
+ * followed by the arguments, like LOGF_DEBUG("x={} y={}", x, y). only the
+ * arguments are copied on the logging thread, see deferred.h.
+ */
+#define LOGF_TRACE(...) LOGF_IMPL(logger::DebugLevel::TRACE, __FILE__, __LINE__, __VA_ARGS__)
+#define LOGF_DEBUG(...) LOGF_IMPL(logger::DebugLevel::DEBUG, __FILE__, __LINE__, __VA_ARGS__)
+#define LOGF_INFO(...)  LOGF_IMPL(logger::DebugLevel::INFO,  __FILE__, __LINE__, __VA_ARGS__)
+#define LOGF_WARN(...)  LOGF_IMPL(logger::DebugLevel::WARN,  __FILE__, __LINE__, __VA_ARGS__)
+#define LOGF_ERROR(...) LOGF_IMPL(logger::DebugLevel::ERROR, __FILE__, __LINE__, __VA_ARGS__)
+#define LOGF_FATAL(...) LOGF_IMPL(logger::DebugLevel::FATAL, __FILE__, __LINE__, __VA_ARGS__)
+#define LOGF_IMPL(level,file,line,...) \
+	if(LOGGER_COMPILED_IN(level) && level>=thread_specific_debuglevel.get()) { \
+		static const logger::FormatDescriptor logger_format_descriptor = { \
+		    level, file, line, LOGF_FORMAT(__VA_ARGS__, ignored), \
+		    decltype(logger::detail::signature_of(__VA_ARGS__))::value, {} }; \
+		logger::log_deferred(&logger_format_descriptor, __VA_ARGS__); \
 	    }
+#define LOGF_FORMAT(format, ...) format
 
 /*
  * note - this is thread safe because it is thread local.
@@ -68,7 +191,7 @@ namespace logger
 #define LOG_INIT(ignored) LOG_INIT_IMPL(__FILE__)
 #define LOG_INIT_IMPL(file) \
 		namespace { \
-		  const thread_local logger::DebugLevel thread_specific_debuglevel = logger::determineDebugLevel ( \
+		  thread_local logger::ThreadLevel thread_specific_debuglevel ( \
 		      file); \
 		}
 #endif /* LOGGER_H_ */
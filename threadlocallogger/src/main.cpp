@@ -6,6 +6,8 @@
 #include <iostream>
 #include <thread>
 
+#include "asyncbackend.h"
+#include "logger.h"
 #include "worker.h"
 
 #include "ThreadName.h"
@@ -18,6 +20,15 @@ main ()
       "debug messages from TRACE all the way up to FATAL.\n"
       "Each thread will have a different debug level";
     {
+      // destroyed after the threads are joined, so all their messages are
+      // written before main says goodbye
+      logger::AsyncBackend async_backend;
+
+      // overrides the default in determineDebugLevel. this could also be
+      // done while the threads run.
+      logger::setDebugLevel ("thread 3", "worker.cpp",
+			     logger::DebugLevel::ERROR);
+
       std::thread t1 ([]()
 	{ ThreadName::setThreadName("thread 1");
 	  worker(1);});
@@ -33,6 +44,8 @@ main ()
       t1.join ();
       t2.join ();
       t3.join ();
+
+      logger::logThreadNames ();
     }
   std::cout << "goodbye from main\n";
 
@@ -0,0 +1,455 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define LOGGER_HAVE_RDTSC 1
+#endif
+
+#include "binaryformat.h"
+#include "logger.h"
+#include "mmapsink.h"
+#include "ThreadName.h"
+
+namespace binary = logger::binary;
+
+namespace
+{
+  std::uint64_t
+  steady_ns ()
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+	std::chrono::steady_clock::now ().time_since_epoch ()).count ();
+  }
+
+  /// the time stamp of a record
+  std::uint64_t
+  ticks ()
+  {
+#ifdef LOGGER_HAVE_RDTSC
+    return __rdtsc ();
+#else
+    return steady_ns ();
+#endif
+  }
+
+#ifdef LOGGER_HAVE_RDTSC
+  const std::uint32_t clock_kind = binary::TimeStampCounter;
+#else
+  const std::uint32_t clock_kind = binary::SteadyClock;
+#endif
+
+  std::uint64_t
+  round_up (std::uint64_t x, std::uint64_t multiple)
+  {
+    return (x + multiple - 1) / multiple * multiple;
+  }
+
+  // guards the slow paths: the list of sites, the dictionary of the sink
+  // and the creation and destruction of the sink
+  std::mutex slow_path_mutex;
+  // every log statement seen by a sink, the id is the index plus one. it
+  // outlives the sinks, so a new sink starts by writing the known ones.
+  std::vector<const logger::FormatDescriptor*> sites;
+
+  // nonzero while a sink exists, different for every sink
+  std::atomic<unsigned> active_generation (0);
+  unsigned last_generation = 0;
+  logger::MmapSink::Impl* active_sink = nullptr;
+
+  /*
+   * where the current thread writes. it is plain data, so it needs no
+   * initialization on thread start.
+   */
+  struct ThreadState
+  {
+    // the sink this state belongs to
+    unsigned generation;
+    binary::ChunkHeader* chunk;
+    // the records of the chunk, nullptr if there is no chunk
+    unsigned char* records;
+    std::uint64_t used;
+    std::uint16_t thread;
+  };
+
+  thread_local ThreadState thread_state =
+    { 0, nullptr, nullptr, 0, 0 };
+}
+
+class logger::MmapSink::Impl
+{
+public:
+  Impl (const std::string& path, std::size_t size, std::size_t chunk_size);
+  ~Impl ();
+
+  /**
+   * gives the thread an id and a first chunk. locks.
+   */
+  void
+  attach (ThreadState& t, unsigned generation);
+
+  /**
+   * @return the site id, or zero if it can not be written to the dictionary
+   */
+  std::uint32_t
+  site_id (const FormatDescriptor* descriptor)
+  {
+    const std::uint32_t id = descriptor->id.load (std::memory_order_relaxed);
+    if (id != 0 && id <= m_sites_written.load (std::memory_order_relaxed))
+      {
+	return id;
+      }
+    return register_site (descriptor);
+  }
+
+  /**
+   * gives the thread a new chunk, without locking
+   * @return false if the file is full
+   */
+  bool
+  claim_chunk (ThreadState& t);
+
+  std::uint64_t
+  chunk_capacity () const
+  {
+    return m_chunk_size - sizeof(binary::ChunkHeader);
+  }
+
+  void
+  drop ()
+  {
+    m_dropped.fetch_add (1, std::memory_order_relaxed);
+  }
+
+  std::uint64_t
+  dropped () const
+  {
+    return m_dropped.load (std::memory_order_relaxed);
+  }
+
+  void
+  count_cut ()
+  {
+    m_truncated.fetch_add (1, std::memory_order_relaxed);
+  }
+
+  std::uint64_t
+  truncated () const
+  {
+    return m_truncated.load (std::memory_order_relaxed);
+  }
+
+  /// writes the sites not yet in the dictionary. needs the lock.
+  void
+  write_sites ();
+
+private:
+  std::uint32_t
+  register_site (const FormatDescriptor* descriptor);
+
+  /// appends an entry to the dictionary. needs the lock.
+  bool
+  write_entry (const binary::DictionaryEntry& entry, const std::string& a,
+	       const std::string& b, const std::string& c);
+
+  int m_fd;
+  unsigned char* m_map;
+  std::size_t m_size;
+  binary::FileHeader* m_header;
+  std::uint64_t m_chunk_size;
+  std::uint64_t m_chunk_count;
+  // guarded by slow_path_mutex
+  std::uint64_t m_dictionary_used;
+  std::atomic<std::uint32_t> m_sites_written;
+  std::atomic<std::uint64_t> m_next_chunk;
+  std::atomic<std::uint64_t> m_dropped;
+  std::atomic<std::uint64_t> m_truncated;
+};
+
+logger::MmapSink::Impl::Impl (const std::string& path, std::size_t size,
+			      std::size_t chunk_size) :
+    m_fd (-1), m_map (nullptr), m_size (size), m_header (nullptr),
+    m_chunk_size (chunk_size), m_chunk_count (0), m_dictionary_used (0),
+    m_sites_written (0), m_next_chunk (0), m_dropped (0), m_truncated (0)
+{
+  const std::uint64_t dictionary_offset = round_up (sizeof(binary::FileHeader),
+						    4096);
+  const std::uint64_t dictionary_capacity = 1 << 20;
+  const std::uint64_t chunks_offset = dictionary_offset + dictionary_capacity;
+  // a chunk must hold at least the largest record, because mmap_log
+  // only checks the room left in the chunk it had before
+  const std::uint64_t largest_record = round_up (
+      sizeof(binary::RecordHeader) + detail::MaxPayload, 8);
+  if (chunk_size < sizeof(binary::ChunkHeader) + largest_record
+      || chunk_size % 8 != 0 || size < chunks_offset + chunk_size)
+    {
+      throw std::runtime_error ("MmapSink: bad file or chunk size");
+    }
+  m_chunk_count = (size - chunks_offset) / chunk_size;
+
+  m_fd = ::open (path.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0)
+    {
+      throw std::runtime_error (
+	  "MmapSink: can not open " + path + ": " + std::strerror (errno));
+    }
+  // reserve the disk blocks now, so writing never waits for allocation.
+  // not all file systems support it.
+  if (::posix_fallocate (m_fd, 0, size) != 0 && ::ftruncate (m_fd, size) != 0)
+    {
+      const int error = errno;
+      ::close (m_fd);
+      throw std::runtime_error (
+	  "MmapSink: can not allocate " + path + ": " + std::strerror (error));
+    }
+  int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+  // fault the pages in now instead of on the logging threads
+  flags |= MAP_POPULATE;
+#endif
+  void* map = ::mmap (nullptr, size, PROT_READ | PROT_WRITE, flags, m_fd, 0);
+  if (map == MAP_FAILED)
+    {
+      const int error = errno;
+      ::close (m_fd);
+      throw std::runtime_error (
+	  "MmapSink: can not map " + path + ": " + std::strerror (error));
+    }
+  m_map = static_cast<unsigned char*> (map);
+
+  m_header = reinterpret_cast<binary::FileHeader*> (m_map);
+  std::memcpy (m_header->magic, binary::magic, sizeof(binary::magic));
+  m_header->version = binary::format_version;
+  m_header->clock = clock_kind;
+  m_header->file_size = size;
+  m_header->dictionary_offset = dictionary_offset;
+  m_header->dictionary_capacity = dictionary_capacity;
+  m_header->chunks_offset = chunks_offset;
+  m_header->chunk_size = chunk_size;
+  m_header->chunk_count = m_chunk_count;
+  m_header->start_ticks = ticks ();
+  m_header->start_ns = steady_ns ();
+  m_header->start_unix_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds> (
+	  std::chrono::system_clock::now ().time_since_epoch ()).count ();
+}
+
+logger::MmapSink::Impl::~Impl ()
+{
+  m_header->stop_ticks = ticks ();
+  m_header->stop_ns = steady_ns ();
+  m_header->dropped_records = dropped ();
+  __atomic_store_n (&m_header->closed, 1, __ATOMIC_RELEASE);
+  ::munmap (m_map, m_size);
+  ::close (m_fd);
+}
+
+void
+logger::MmapSink::Impl::attach (ThreadState& t, unsigned generation)
+{
+  std::unique_lock<std::mutex> lock (slow_path_mutex);
+  t.generation = generation;
+  t.chunk = nullptr;
+  t.records = nullptr;
+  const unsigned id = ThreadName::getThreadId ();
+  t.thread = static_cast<std::uint16_t> (id);
+
+  std::string name;
+  try
+    {
+      name = ThreadName::getThreadName ();
+    }
+  catch (const std::exception&)
+    {
+    }
+  binary::DictionaryEntry entry =
+    { binary::DictionaryEntry::Thread, t.thread, 0, 0 };
+  write_entry (entry, std::to_string (id), name, std::string ());
+  lock.unlock ();
+
+  claim_chunk (t);
+}
+
+bool
+logger::MmapSink::Impl::claim_chunk (ThreadState& t)
+{
+  // checked first, so a full file does not make every thread write the
+  // shared counter on every record
+  if (m_next_chunk.load (std::memory_order_relaxed) >= m_chunk_count)
+    {
+      return false;
+    }
+  const std::uint64_t index = m_next_chunk.fetch_add (
+      1, std::memory_order_relaxed);
+  if (index >= m_chunk_count)
+    {
+      return false;
+    }
+  unsigned char* chunk = m_map + m_header->chunks_offset
+      + index * m_chunk_size;
+  t.chunk = reinterpret_cast<binary::ChunkHeader*> (chunk);
+  t.chunk->thread = t.thread;
+  t.records = chunk + sizeof(binary::ChunkHeader);
+  t.used = 0;
+  __atomic_fetch_add (&m_header->chunks_used, 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+std::uint32_t
+logger::MmapSink::Impl::register_site (const FormatDescriptor* descriptor)
+{
+  std::unique_lock<std::mutex> lock (slow_path_mutex);
+  std::uint32_t id = descriptor->id.load (std::memory_order_relaxed);
+  if (id == 0)
+    {
+      sites.push_back (descriptor);
+      id = static_cast<std::uint32_t> (sites.size ());
+      descriptor->id.store (id, std::memory_order_relaxed);
+    }
+  write_sites ();
+  return id <= m_sites_written.load (std::memory_order_relaxed) ? id : 0;
+}
+
+void
+logger::MmapSink::Impl::write_sites ()
+{
+  std::uint32_t written = m_sites_written.load (std::memory_order_relaxed);
+  for (; written < sites.size (); ++written)
+    {
+      const FormatDescriptor* d = sites[written];
+      binary::DictionaryEntry entry =
+	{ binary::DictionaryEntry::Site, written + 1,
+	    static_cast<std::uint32_t> (d->level), d->line };
+      if (!write_entry (entry, d->file, d->format, d->types))
+	{
+	  break;
+	}
+    }
+  m_sites_written.store (written, std::memory_order_relaxed);
+}
+
+bool
+logger::MmapSink::Impl::write_entry (const binary::DictionaryEntry& entry,
+				     const std::string& a,
+				     const std::string& b,
+				     const std::string& c)
+{
+  const std::uint64_t size = sizeof(entry) + a.size () + b.size ()
+      + c.size () + 3;
+  if (m_dictionary_used + size > m_header->dictionary_capacity)
+    {
+      return false;
+    }
+  unsigned char* p = m_map + m_header->dictionary_offset + m_dictionary_used;
+  std::memcpy (p, &entry, sizeof(entry));
+  p += sizeof(entry);
+  // the strings including their terminating zeros
+  std::memcpy (p, a.c_str (), a.size () + 1);
+  p += a.size () + 1;
+  std::memcpy (p, b.c_str (), b.size () + 1);
+  p += b.size () + 1;
+  std::memcpy (p, c.c_str (), c.size () + 1);
+  m_dictionary_used += size;
+  __atomic_store_n (&m_header->dictionary_used, m_dictionary_used,
+		    __ATOMIC_RELEASE);
+  return true;
+}
+
+logger::MmapSink::MmapSink (const std::string& path, std::size_t size,
+			    std::size_t chunk_size) :
+    m_impl (nullptr)
+{
+  std::unique_lock<std::mutex> lock (slow_path_mutex);
+  if (active_sink)
+    {
+      throw std::logic_error ("there can only be one MmapSink");
+    }
+  m_impl = new Impl (path, size, chunk_size);
+  // statements seen by an earlier sink keep their ids
+  m_impl->write_sites ();
+  active_sink = m_impl;
+  active_generation.store (++last_generation, std::memory_order_release);
+}
+
+logger::MmapSink::~MmapSink ()
+{
+    {
+      std::unique_lock<std::mutex> lock (slow_path_mutex);
+      active_generation.store (0, std::memory_order_release);
+      active_sink = nullptr;
+    }
+  delete m_impl;
+}
+
+std::uint64_t
+logger::MmapSink::droppedRecords () const
+{
+  return m_impl->dropped ();
+}
+
+std::uint64_t
+logger::MmapSink::truncatedRecords () const
+{
+  return m_impl->truncated ();
+}
+
+bool
+logger::detail::mmap_sink_active ()
+{
+  return active_generation.load (std::memory_order_relaxed) != 0;
+}
+
+bool
+logger::detail::mmap_log (const FormatDescriptor* descriptor,
+			  const unsigned char* args, std::size_t size, bool cut)
+{
+  const unsigned generation = active_generation.load (
+      std::memory_order_acquire);
+  if (generation == 0)
+    {
+      return false;
+    }
+  MmapSink::Impl* sink = active_sink;
+  ThreadState& t = thread_state;
+  if (t.generation != generation)
+    {
+      sink->attach (t, generation);
+    }
+  const std::uint32_t site = sink->site_id (descriptor);
+  // records are padded to 8 bytes, so the headers are aligned
+  const std::uint64_t need = round_up (sizeof(binary::RecordHeader) + size, 8);
+  if (site == 0 || !t.records
+      || (t.used + need > sink->chunk_capacity () && !sink->claim_chunk (t)))
+    {
+      sink->drop ();
+      return true;
+    }
+  if (cut)
+    {
+      sink->count_cut ();
+    }
+  const binary::RecordHeader header =
+    { ticks (), site, t.thread, static_cast<std::uint16_t> (
+	size | (cut ? binary::RecordHeader::Cut : 0)) };
+  unsigned char* p = t.records + t.used;
+  std::memcpy (p, &header, sizeof(header));
+  std::memcpy (p + sizeof(header), args, size);
+  t.used += need;
+  __atomic_store_n (&t.chunk->used, t.used, __ATOMIC_RELEASE);
+  return true;
+}
@@ -0,0 +1,96 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#ifndef MMAPSINK_H_
+#define MMAPSINK_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "deferred.h"
+
+namespace logger
+{
+  /*
+   * while an object of this class exists, log statements write binary
+   * records (see binaryformat.h) to a preallocated memory mapped file,
+   * instead of text to stdout. it takes precedence over the AsyncBackend.
+   *
+   * each thread writes to chunks of the file of its own, so appending a
+   * record is a copy and a store, without locks or system calls. a lock is
+   * only taken the first time a thread logs and the first time a log
+   * statement is seen. when the file is full, records are dropped and
+   * counted. text and string arguments that do not fit in a record are
+   * cut, marked and counted. there is no background thread, the kernel
+   * writes the pages.
+   *
+   * the file is turned back into text with tlldecode.
+   *
+   * like the AsyncBackend, create it before the threads that log and
+   * destroy it after they have been joined. statements logged with log_impl
+   * directly have no site, and go to the other backends.
+   */
+  class MmapSink
+  {
+  public:
+    /**
+     * creates the file, replacing any existing one
+     * @param path the file name
+     * @param size the file size, which is allocated up front
+     * @param chunk_size how much a thread takes at a time, a multiple of 8
+     * with room for at least one record of the largest size
+     * @throws std::runtime_error if the sizes are bad or the file can not be
+     * created
+     */
+    explicit
+    MmapSink (const std::string& path, std::size_t size = 256 << 20,
+	      std::size_t chunk_size = 1 << 20);
+    ~MmapSink ();
+
+    /**
+     * @return the number of records dropped so far, because the file was full
+     */
+    std::uint64_t
+    droppedRecords () const;
+
+    /**
+     * @return the number of records whose text or a string argument was cut
+     * so far, because it did not fit
+     */
+    std::uint64_t
+    truncatedRecords () const;
+
+    MmapSink (const MmapSink&) = delete;
+    MmapSink&
+    operator= (const MmapSink&) = delete;
+
+    class Impl;
+
+  private:
+    Impl* m_impl;
+  };
+
+  namespace detail
+  {
+    /**
+     * @return true if there is a binary sink, so the caller can skip
+     * encoding a record that would not be used
+     */
+    bool
+    mmap_sink_active ();
+
+    /**
+     * appends a record to the binary sink
+     * @param cut true if a string argument was cut
+     * @return false if there is no binary sink
+     */
+    bool
+    mmap_log (const FormatDescriptor* descriptor, const unsigned char* args,
+	      std::size_t size, bool cut);
+  }
+}
+
+#endif /* MMAPSINK_H_ */
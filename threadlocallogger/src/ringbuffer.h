@@ -0,0 +1,116 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+#ifndef RINGBUFFER_H_
+#define RINGBUFFER_H_
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ * a bounded single producer single consumer queue. the producer fills a slot
+ * in place and publishes it with one release store, so there is no locking
+ * and no allocation after construction.
+ *
+ * the indices written by the producer and the consumer are kept on separate
+ * cache lines, and each side keeps a private copy of the other side's index
+ * so it only has to read the shared one when the ring looks full or empty.
+ * padding is used instead of alignas, since new does not honour extended
+ * alignment before C++17.
+ */
+template <typename T, std::size_t Capacity>
+class RingBuffer
+{
+  static_assert ((Capacity & (Capacity - 1)) == 0,
+		 "the capacity must be a power of two");
+
+public:
+  RingBuffer () :
+      m_head (0), m_cached_tail (0), m_tail (0), m_cached_head (0)
+  {
+  }
+
+  RingBuffer (const RingBuffer&) = delete;
+  RingBuffer&
+  operator= (const RingBuffer&) = delete;
+
+  /**
+   * producer side.
+   * @return the slot to fill, or nullptr if the ring is full. the slot is
+   * not visible to the consumer until push() is called.
+   */
+  T*
+  reserve ()
+  {
+    const std::size_t head = m_head.load (std::memory_order_relaxed);
+    if (head - m_cached_tail == Capacity)
+      {
+	m_cached_tail = m_tail.load (std::memory_order_acquire);
+	if (head - m_cached_tail == Capacity)
+	  {
+	    return nullptr;
+	  }
+      }
+    return &m_slots[head & (Capacity - 1)];
+  }
+
+  /**
+   * producer side. publishes the slot returned by the last reserve().
+   */
+  void
+  push ()
+  {
+    m_head.store (m_head.load (std::memory_order_relaxed) + 1,
+		  std::memory_order_release);
+  }
+
+  /**
+   * consumer side.
+   * @return the oldest element, or nullptr if the ring is empty
+   */
+  const T*
+  front ()
+  {
+    const std::size_t tail = m_tail.load (std::memory_order_relaxed);
+    if (tail == m_cached_head)
+      {
+	m_cached_head = m_head.load (std::memory_order_acquire);
+	if (tail == m_cached_head)
+	  {
+	    return nullptr;
+	  }
+      }
+    return &m_slots[tail & (Capacity - 1)];
+  }
+
+  /**
+   * consumer side. releases the element returned by front() to the producer.
+   */
+  void
+  pop ()
+  {
+    m_tail.store (m_tail.load (std::memory_order_relaxed) + 1,
+		  std::memory_order_release);
+  }
+
+private:
+  enum
+  {
+    CacheLine = 64
+  };
+
+  char m_pad0[CacheLine];
+  // written by the producer
+  std::atomic<std::size_t> m_head;
+  std::size_t m_cached_tail;
+  char m_pad1[CacheLine];
+  // written by the consumer
+  std::atomic<std::size_t> m_tail;
+  std::size_t m_cached_head;
+  char m_pad2[CacheLine];
+  T m_slots[Capacity];
+};
+
+#endif /* RINGBUFFER_H_ */
@@ -3,6 +3,8 @@
  * http://www.pauldreik.se/
  * License: Boost 1.0
  */
+#include <string>
+
 #include "logger.h"
 #include "worker.h"
 
@@ -22,6 +24,9 @@ worker (int workerid)
   LOG_ERROR("test msg level ERROR from worker "<<workerid);
   LOG_FATAL("test msg level FATAL from worker "<<workerid);
 
+  LOGF_INFO("deferred msg from worker {}, pi={} name={}", workerid, 3.14159,
+	    std::string ("tll"));
+
   LOG_INFO("goodbye from worker "<<workerid);
 
   return 0;
@@ -0,0 +1,99 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * checks that the AsyncBackend marks and counts messages that are too long
+ * for its records, and leaves the others alone.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "asyncbackend.h"
+#include "logger.h"
+
+LOG_INIT();
+
+namespace
+{
+  int failures = 0;
+
+  void
+  check (bool ok, const char* what)
+  {
+    if (!ok)
+      {
+	std::fprintf (stderr, "failed: %s\n", what);
+	++failures;
+      }
+  }
+
+  const char* const path = "test_asyncbackend.log";
+
+  // the text of a log line, after the prefix written by the backend
+  std::string
+  message (const std::string& line)
+  {
+    const std::string::size_type colon = line.find (": ");
+    return colon == std::string::npos ?
+	std::string () : line.substr (colon + 2);
+  }
+}
+
+int
+main ()
+{
+  logger::setDebugLevel ("", "", logger::DebugLevel::TRACE);
+  const std::size_t fits = logger::detail::MaxString;
+  const std::string exact (fits, 'a');
+  const std::string longer (300, 'b');
+
+  // the log output goes to a file, which is read back below
+  if (!std::freopen (path, "w", stdout))
+    {
+      std::perror (path);
+      return EXIT_FAILURE;
+    }
+    {
+      logger::AsyncBackend backend;
+      LOG_INFO(exact);
+      LOG_INFO(longer);
+    }
+  std::cout.flush ();
+  std::fflush (stdout);
+
+  std::ifstream in (path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline (in, line))
+    {
+      lines.push_back (line);
+    }
+  std::remove (path);
+
+  check (lines.size () == 2, "both messages are written");
+  if (lines.size () == 2)
+    {
+      check (message (lines[0]) == exact,
+	     "a message that fits is written as is");
+      check (message (lines[1]) == longer.substr (0, fits) + "...",
+	     "a message that does not fit is cut and marked");
+    }
+  check (logger::AsyncBackend::truncatedRecords () == 1,
+	 "the cut message is counted");
+  check (logger::AsyncBackend::droppedRecords () == 0,
+	 "nothing is dropped");
+
+  if (failures == 0)
+    {
+      std::fprintf (stderr, "all tests passed\n");
+    }
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,160 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * checks that arguments encoded by log_deferred come back out of
+ * format_deferred as they would have been written with operator<<, and that
+ * bad input gives a marker instead of a crash.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "deferred.h"
+#include "logger.h"
+
+namespace
+{
+  int failures = 0;
+
+  void
+  check (const std::string& got, const std::string& expected,
+	 const char* what)
+  {
+    if (got != expected)
+      {
+	std::fprintf (stderr, "failed: %s\n  got      \"%s\"\n"
+		      "  expected \"%s\"\n", what, got.c_str (),
+		      expected.c_str ());
+	++failures;
+      }
+  }
+
+  std::string
+  format (const char* format, const char* types, const unsigned char* args,
+	  std::size_t size)
+  {
+    const logger::FormatDescriptor descriptor =
+      { logger::DebugLevel::INFO, __FILE__, __LINE__, format, types, {} };
+    std::ostringstream oss;
+    logger::format_deferred (oss, descriptor, args, size);
+    return oss.str ();
+  }
+
+  /**
+   * encodes the arguments like log_deferred does, and formats them again
+   */
+  template <typename ... Args>
+  std::string
+  round_trip (const char* format_string, const Args&... args)
+  {
+    logger::detail::Encoder encoder (logger::detail::FixedSize<
+	typename std::decay<Args>::type...>::value);
+    logger::detail::encode (encoder, args...);
+    return format (format_string,
+		   decltype(logger::detail::signature_of (format_string,
+							  args...))::value,
+		   encoder.data (), encoder.size ());
+  }
+
+  template <typename T>
+  std::string
+  streamed (const T& x)
+  {
+    std::ostringstream oss;
+    oss << x;
+    return oss.str ();
+  }
+
+  void
+  test_types ()
+  {
+    check (decltype(logger::detail::signature_of ("", true, 'c', 1, 1U, 1.0,
+						  &failures, "s",
+						  std::string ()))::value,
+	   "bciudpss", "the type codes");
+    check (round_trip ("{} {}", true, false), "1 0", "bool");
+    check (round_trip ("<{}>", 'x'), "<x>", "char");
+    check (round_trip ("{} {} {}", -5, std::int64_t (INT64_MIN),
+		       static_cast<short> (-7)),
+	   "-5 " + streamed (INT64_MIN) + " -7", "signed integers");
+    check (round_trip ("{} {}", 7U, UINT64_MAX),
+	   "7 " + streamed (UINT64_MAX), "unsigned integers");
+    check (round_trip ("{} {}", 2.5, 0.1f), "2.5 " + streamed (double (0.1f)),
+	   "floating point");
+    check (round_trip ("{}", &failures), streamed (&failures), "pointer");
+    char buffer[] = "mutable";
+    check (round_trip ("{} {} {}", "literal", std::string ("string"), buffer),
+	   "literal string mutable", "strings");
+    check (round_trip ("[{}]", static_cast<const char*> (nullptr)), "[]",
+	   "a null string");
+    check (round_trip ("no arguments"), "no arguments", "no arguments");
+  }
+
+  void
+  test_placeholders ()
+  {
+    check (round_trip ("{}", 1, 2, "three"), "1 2 three",
+	   "arguments without a placeholder are appended");
+    const unsigned char none[1] =
+      { 0 };
+    check (format ("{} and {}", "", none, 0), "{} and {}",
+	   "placeholders without arguments are kept");
+    check (format ("{{}", "", none, 0), "{{}", "a lone brace is kept");
+  }
+
+  void
+  test_cut_strings ()
+  {
+    const std::size_t fits = logger::detail::MaxString;
+    const std::string exact (fits, 'a');
+    check (round_trip ("{}", exact), exact, "a string that just fits");
+    const std::string longer (300, 'b');
+    check (round_trip ("{}", longer), longer.substr (0, fits) + "...",
+	   "a string that does not fit is cut and marked");
+    // the fixed part of the integer is reserved before the string is cut
+    check (round_trip ("{} {}", longer, 1),
+	   longer.substr (0, fits - 8) + "... 1",
+	   "a string is cut to leave room for later arguments");
+  }
+
+  void
+  test_corrupt ()
+  {
+    const std::string suffix = " [corrupt arguments]";
+    const unsigned char bytes[8] =
+      { 1, 0, 0, 0, 0, 0, 0, 0 };
+    check (format ("{}", "i", bytes, 8), "1", "an intact integer");
+    check (format ("a{}b", "i", bytes, 7), "ab" + suffix,
+	   "a truncated integer");
+    check (format ("{} {}", "ii", bytes, 8), "1 " + suffix,
+	   "a missing integer");
+    const unsigned char string[4] =
+      { 5, 0, 'a', 'b' };
+    check (format ("{}", "s", string, 4), suffix,
+	   "a string longer than the record");
+    check (format ("{}", "s", string, 1), suffix, "a truncated length");
+    check (format ("{}", "?", bytes, 8), suffix, "an unknown type code");
+  }
+}
+
+int
+main ()
+{
+  test_types ();
+  test_placeholders ();
+  test_cut_strings ();
+  test_corrupt ();
+  if (failures == 0)
+    {
+      std::printf ("all tests passed\n");
+    }
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,207 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * checks that setDebugLevel and clearDebugLevels, called from one thread,
+ * change what a running thread logs, and that the settings take precedence
+ * as documented.
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "ThreadName.h"
+#include "logger.h"
+
+LOG_INIT();
+
+namespace
+{
+  int failures = 0;
+
+  void
+  check (bool ok, const std::string& what)
+  {
+    if (!ok)
+      {
+	std::fprintf (stderr, "failed: %s\n", what.c_str ());
+	++failures;
+      }
+  }
+
+  const char* const path = "test_levels.log";
+
+  // the step the worker should log next, and the last one it logged
+  std::atomic<int> requested (0);
+  std::atomic<int> logged (-1);
+  const int stop = -1;
+
+  /**
+   * logs at every level for each requested step, until told to stop
+   */
+  void
+  worker ()
+  {
+    ThreadName::setThreadName ("worker");
+    int step = 0;
+    for (;;)
+      {
+	LOG_TRACE("step " << step);
+	LOG_DEBUG("step " << step);
+	LOG_INFO("step " << step);
+	LOG_WARN("step " << step);
+	LOG_ERROR("step " << step);
+	LOG_FATAL("step " << step);
+	logged.store (step, std::memory_order_release);
+	int next;
+	while ((next = requested.load (std::memory_order_acquire)) == step)
+	  {
+	    std::this_thread::yield ();
+	  }
+	if (next == stop)
+	  {
+	    return;
+	  }
+	step = next;
+      }
+  }
+
+  void
+  wait_for (int step)
+  {
+    while (logged.load (std::memory_order_acquire) != step)
+      {
+	std::this_thread::yield ();
+      }
+  }
+
+  /**
+   * @return the lowest level logged for each step
+   */
+  std::map<int, int>
+  lowest_levels ()
+  {
+    std::map<int, int> lowest;
+    std::ifstream in (path);
+    std::string line;
+    while (std::getline (in, line))
+      {
+	const std::string::size_type level = line.find (" level=");
+	const std::string::size_type step = line.find (": step ");
+	if (level == std::string::npos || step == std::string::npos)
+	  {
+	    continue;
+	  }
+	const int l = std::atoi (line.c_str () + level + 7);
+	const int s = std::atoi (line.c_str () + step + 7);
+	if (!lowest.count (s) || l < lowest[s])
+	  {
+	    lowest[s] = l;
+	  }
+      }
+    return lowest;
+  }
+}
+
+int
+main ()
+{
+  using logger::DebugLevel;
+  struct Step
+  {
+    const char* what;
+    DebugLevel expected;
+  };
+  const Step steps[] =
+    {
+      { "the default for an unknown thread", DebugLevel::DISABLE_LOGGING },
+      { "a setting for all", DebugLevel::WARN },
+      { "the file wins over all", DebugLevel::ERROR },
+      { "the thread wins over the file", DebugLevel::DEBUG },
+      { "thread and file win over the thread", DebugLevel::INFO },
+      { "a weaker setting does not win", DebugLevel::INFO },
+      { "a later setting wins a tie", DebugLevel::TRACE },
+      { "another thread is not affected", DebugLevel::TRACE },
+      { "another file is not affected", DebugLevel::TRACE },
+      { "clearDebugLevels", DebugLevel::DISABLE_LOGGING },
+    };
+  const int count = sizeof(steps) / sizeof(steps[0]);
+  const std::string file = "test_levels.cpp";
+
+  // the log goes to a file, which is read back below
+  if (!std::freopen (path, "w", stdout))
+    {
+      std::perror (path);
+      return EXIT_FAILURE;
+    }
+
+  std::thread t (worker);
+  for (int step = 0; step < count; ++step)
+    {
+      switch (step)
+	{
+	case 1:
+	  logger::setDebugLevel ("", "", DebugLevel::WARN);
+	  break;
+	case 2:
+	  logger::setDebugLevel ("", file, DebugLevel::ERROR);
+	  break;
+	case 3:
+	  logger::setDebugLevel ("worker", "", DebugLevel::DEBUG);
+	  break;
+	case 4:
+	  logger::setDebugLevel ("worker", file, DebugLevel::INFO);
+	  break;
+	case 5:
+	  logger::setDebugLevel ("worker", "", DebugLevel::FATAL);
+	  break;
+	case 6:
+	  logger::setDebugLevel ("worker", file, DebugLevel::TRACE);
+	  break;
+	case 7:
+	  logger::setDebugLevel ("other", file, DebugLevel::FATAL);
+	  break;
+	case 8:
+	  logger::setDebugLevel ("worker", "other.cpp", DebugLevel::FATAL);
+	  break;
+	case 9:
+	  logger::clearDebugLevels ();
+	  break;
+	}
+      requested.store (step, std::memory_order_release);
+      wait_for (step);
+    }
+  requested.store (stop, std::memory_order_release);
+  t.join ();
+  std::cout.flush ();
+  std::fflush (stdout);
+
+  const std::map<int, int> lowest = lowest_levels ();
+  std::remove (path);
+  for (int step = 0; step < count; ++step)
+    {
+      const auto found = lowest.find (step);
+      const int got = found == lowest.end () ?
+	  int (DebugLevel::DISABLE_LOGGING) : found->second;
+      std::ostringstream what;
+      what << "step " << step << ", " << steps[step].what << ": expected level "
+	  << int (steps[step].expected) << ", got " << got;
+      check (got == int (steps[step].expected), what.str ());
+    }
+
+  if (failures == 0)
+    {
+      std::fprintf (stderr, "all tests passed\n");
+    }
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
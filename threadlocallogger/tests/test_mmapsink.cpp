@@ -0,0 +1,253 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * checks that MmapSink rejects chunks too small for a record, that a sink
+ * with the smallest allowed chunks keeps every record inside its chunk, and
+ * that tlldecode turns what the sink wrote back into the text the text
+ * backend writes. the path to tlldecode is the argument.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "binaryformat.h"
+#include "logger.h"
+#include "mmapsink.h"
+
+LOG_INIT();
+
+namespace
+{
+  int failures = 0;
+
+  void
+  check (bool ok, const char* what)
+  {
+    if (!ok)
+      {
+	std::fprintf (stderr, "failed: %s\n", what);
+	++failures;
+      }
+  }
+
+  const char* const path = "test_mmapsink.tll";
+
+  bool
+  rejects (std::size_t chunk_size)
+  {
+    try
+      {
+	logger::MmapSink sink (path, 4 << 20, chunk_size);
+      }
+    catch (const std::runtime_error&)
+      {
+	return true;
+      }
+    return false;
+  }
+
+  template <typename T>
+  T
+  load (const std::vector<char>& file, std::uint64_t offset)
+  {
+    T x;
+    std::copy (file.begin () + offset, file.begin () + offset + sizeof(x),
+	       reinterpret_cast<char*> (&x));
+    return x;
+  }
+
+  void
+  test_chunk_size ()
+  {
+    namespace binary = logger::binary;
+    const std::size_t record = (sizeof(binary::RecordHeader)
+	+ logger::detail::MaxPayload + 7) / 8 * 8;
+    const std::size_t chunk = sizeof(binary::ChunkHeader) + record;
+    check (rejects (24), "a chunk of 24 bytes is rejected");
+    check (rejects (chunk - 8), "a chunk smaller than a record is rejected");
+
+    // every record is as large as possible, so each chunk takes exactly one
+    const int chunks = 8;
+    const int records = 100;
+    std::uint64_t dropped;
+      {
+	const std::size_t size = 4096 + (1 << 20) + chunks * chunk;
+	logger::MmapSink sink (path, size, chunk);
+	const std::string text (300, 'x');
+	for (int i = 0; i < records; ++i)
+	  {
+	    LOG_INFO(text);
+	  }
+	dropped = sink.droppedRecords ();
+      }
+    check (dropped == records - chunks,
+	   "the records that do not fit are dropped");
+
+    std::ifstream in (path, std::ios::binary);
+    const std::vector<char> file ((std::istreambuf_iterator<char> (in)),
+				  std::istreambuf_iterator<char> ());
+    std::remove (path);
+    check (file.size () >= sizeof(binary::FileHeader), "the file was written");
+    if (file.size () < sizeof(binary::FileHeader))
+      {
+	return;
+      }
+    const binary::FileHeader header = load<binary::FileHeader> (file, 0);
+    check (header.chunk_count == std::uint64_t (chunks),
+	   "the file holds the expected number of chunks");
+    check (header.dropped_records == dropped, "the file counts the drops");
+    for (std::uint64_t c = 0; c < header.chunk_count; ++c)
+      {
+	const binary::ChunkHeader h = load<binary::ChunkHeader> (
+	    file, header.chunks_offset + c * chunk);
+	check (h.used == record, "each chunk holds one whole record");
+      }
+  }
+
+  void
+  work (int t)
+  {
+    for (int i = 0; i < 100; ++i)
+      {
+	LOG_INFO("stream " << t << ' ' << i);
+	LOGF_WARN("deferred {} {} {} {} {}", t, i, 2.5, 'c', "str");
+	LOGF_ERROR("appended", std::string ("text"), -i);
+      }
+  }
+
+  void
+  run_two_threads ()
+  {
+    std::thread a (work, 1);
+    std::thread b (work, 2);
+    a.join ();
+    b.join ();
+  }
+
+  /*
+   * the lines of a log, grouped by thread without the thread id, because the
+   * threads of each run get new ids. the groups are sorted, since the
+   * threads may come in any order.
+   */
+  std::vector<std::vector<std::string> >
+  read_log (const std::string& file)
+  {
+    std::map<std::string, std::vector<std::string> > threads;
+    std::ifstream in (file.c_str ());
+    std::string line;
+    while (std::getline (in, line))
+      {
+	const std::string::size_type space = line.find (' ');
+	threads[line.substr (0, space)].push_back (line.substr (space + 1));
+      }
+    std::vector<std::vector<std::string> > ret;
+    for (const auto& t : threads)
+      {
+	ret.push_back (t.second);
+      }
+    std::sort (ret.begin (), ret.end ());
+    return ret;
+  }
+
+  /**
+   * decodes the file of the sink to text
+   * @return false if tlldecode failed
+   */
+  bool
+  decode (const std::string& tlldecode, const std::string& text)
+  {
+    const std::string command = "\"" + tlldecode + "\" " + path + " > " + text
+	+ " 2> /dev/null";
+    return std::system (command.c_str ()) == 0;
+  }
+
+  void
+  test_round_trip (const std::string& tlldecode)
+  {
+    const std::string expected = "test_mmapsink_text.log";
+    const std::string decoded = "test_mmapsink_decoded.log";
+
+    // the text backend writes to stdout, which goes to a file meanwhile
+    std::fflush (stdout);
+    const int saved_stdout = dup (STDOUT_FILENO);
+    if (!std::freopen (expected.c_str (), "w", stdout))
+      {
+	std::perror (expected.c_str ());
+	std::exit (EXIT_FAILURE);
+      }
+    run_two_threads ();
+    std::cout.flush ();
+    std::fflush (stdout);
+    dup2 (saved_stdout, STDOUT_FILENO);
+    close (saved_stdout);
+
+      {
+	logger::MmapSink sink (path, 4 << 20);
+	run_two_threads ();
+      }
+    check (decode (tlldecode, decoded), "tlldecode succeeds");
+    const std::vector<std::vector<std::string> > text = read_log (expected);
+    check (text.size () == 2 && text[0].size () == 300,
+	   "the text backend wrote all lines");
+    check (read_log (decoded) == text,
+	   "the decoded lines equal those of the text backend");
+
+    // the text backend does not cut, so this is checked on its own
+    const std::string longer (300, 'b');
+    std::uint64_t cut;
+      {
+	logger::MmapSink sink (path, 4 << 20);
+	LOG_INFO(longer);
+	cut = sink.truncatedRecords ();
+      }
+    check (cut == 1, "the cut record is counted");
+    check (decode (tlldecode, decoded), "tlldecode succeeds");
+    const std::vector<std::vector<std::string> > lines = read_log (decoded);
+    const std::string tail = ": "
+	+ longer.substr (0, logger::detail::MaxString) + "...";
+    check (lines.size () == 1 && lines[0].size () == 1
+	       && lines[0][0].size () > tail.size ()
+	       && lines[0][0].compare (lines[0][0].size () - tail.size (),
+				       tail.size (), tail) == 0,
+	   "a cut record is decoded with a marker");
+
+    std::remove (path);
+    std::remove (expected.c_str ());
+    std::remove (decoded.c_str ());
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  if (argc != 2)
+    {
+      std::fprintf (stderr, "usage: %s path-to-tlldecode\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  logger::setDebugLevel ("", "", logger::DebugLevel::TRACE);
+  test_chunk_size ();
+  test_round_trip (argv[1]);
+
+  if (failures == 0)
+    {
+      std::printf ("all tests passed\n");
+    }
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
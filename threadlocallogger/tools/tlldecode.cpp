@@ -0,0 +1,322 @@
+/*
+ * By Paul Dreik
+ * http://www.pauldreik.se/
+ * License: Boost 1.0
+ */
+
+/*
+ * turns a file written by MmapSink back into the text the other backends
+ * write, with the records of all threads merged in time order. it also
+ * reads files that were not closed, for instance after a crash, up to the
+ * last record that was completely written.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "binaryformat.h"
+#include "logger.h"
+
+namespace binary = logger::binary;
+
+namespace
+{
+  struct Site
+  {
+    Site () :
+	known (false), level (0), line (0)
+    {
+    }
+    bool known;
+    std::uint32_t level;
+    std::int32_t line;
+    std::string file;
+    std::string format;
+    std::string types;
+  };
+
+  struct Thread
+  {
+    std::string id;
+    std::string name;
+  };
+
+  struct Record
+  {
+    std::uint64_t timestamp;
+    // the position in the file, which keeps the order of one thread
+    std::uint64_t offset;
+  };
+
+  bool
+  operator< (const Record& a, const Record& b)
+  {
+    return a.timestamp != b.timestamp ?
+	a.timestamp < b.timestamp : a.offset < b.offset;
+  }
+
+  template <typename T>
+  T
+  load (const unsigned char* p)
+  {
+    T x;
+    std::memcpy (&x, p, sizeof(x));
+    return x;
+  }
+
+  /**
+   * reads a zero terminated string
+   * @return false if it runs past end
+   */
+  bool
+  read_string (const unsigned char*& p, const unsigned char* end,
+	       std::string& s)
+  {
+    const void* zero = std::memchr (p, 0, end - p);
+    if (!zero)
+      {
+	return false;
+      }
+    s.assign (reinterpret_cast<const char*> (p),
+	      static_cast<const unsigned char*> (zero) - p);
+    p = static_cast<const unsigned char*> (zero) + 1;
+    return true;
+  }
+
+  void
+  read_dictionary (const unsigned char* p, const unsigned char* end,
+		   std::vector<Site>& sites, std::vector<Thread>& threads)
+  {
+    while (end - p >= static_cast<std::ptrdiff_t> (sizeof(
+	binary::DictionaryEntry)))
+      {
+	const binary::DictionaryEntry entry = load<binary::DictionaryEntry> (
+	    p);
+	p += sizeof(entry);
+	std::string a, b, c;
+	if (!read_string (p, end, a) || !read_string (p, end, b)
+	    || !read_string (p, end, c))
+	  {
+	    std::cerr << "truncated dictionary\n";
+	    return;
+	  }
+	if (entry.kind == binary::DictionaryEntry::Site)
+	  {
+	    if (entry.id >= sites.size ())
+	      {
+		sites.resize (entry.id + 1);
+	      }
+	    Site& site = sites[entry.id];
+	    site.known = true;
+	    site.level = entry.level;
+	    site.line = entry.line;
+	    site.file = a;
+	    site.format = b;
+	    site.types = c;
+	  }
+	else if (entry.kind == binary::DictionaryEntry::Thread)
+	  {
+	    if (entry.id >= threads.size ())
+	      {
+		threads.resize (entry.id + 1);
+	      }
+	    threads[entry.id].id = a;
+	    threads[entry.id].name = b;
+	  }
+      }
+  }
+
+  int
+  decode (const unsigned char* map, std::uint64_t file_size, bool times)
+  {
+    if (file_size < sizeof(binary::FileHeader))
+      {
+	std::cerr << "the file is too small\n";
+	return EXIT_FAILURE;
+      }
+    const binary::FileHeader header = load<binary::FileHeader> (map);
+    if (std::memcmp (header.magic, binary::magic, sizeof(binary::magic)) != 0
+	|| header.version != binary::format_version)
+      {
+	std::cerr << "not a log file of a known version\n";
+	return EXIT_FAILURE;
+      }
+    if (header.file_size > file_size
+	|| header.dictionary_offset + header.dictionary_capacity
+	    > header.chunks_offset
+	|| header.dictionary_used > header.dictionary_capacity
+	|| header.chunk_size <= sizeof(binary::ChunkHeader)
+	|| header.chunks_offset > header.file_size
+	|| header.chunk_count
+	    > (header.file_size - header.chunks_offset) / header.chunk_size)
+      {
+	std::cerr << "corrupt header\n";
+	return EXIT_FAILURE;
+      }
+
+    std::vector<Site> sites;
+    std::vector<Thread> threads;
+    const unsigned char* dictionary = map + header.dictionary_offset;
+    read_dictionary (dictionary, dictionary + header.dictionary_used, sites,
+		     threads);
+
+    std::vector<Record> records;
+    const std::uint64_t chunks = std::min (header.chunks_used,
+					   header.chunk_count);
+    for (std::uint64_t c = 0; c < chunks; ++c)
+      {
+	const std::uint64_t chunk_offset = header.chunks_offset
+	    + c * header.chunk_size;
+	const binary::ChunkHeader chunk = load<binary::ChunkHeader> (
+	    map + chunk_offset);
+	const std::uint64_t used = std::min<std::uint64_t> (
+	    chunk.used, header.chunk_size - sizeof(binary::ChunkHeader));
+	std::uint64_t offset = chunk_offset + sizeof(binary::ChunkHeader);
+	const std::uint64_t end = offset + used;
+	while (offset + sizeof(binary::RecordHeader) <= end)
+	  {
+	    const binary::RecordHeader r = load<binary::RecordHeader> (
+		map + offset);
+	    const std::uint64_t size = (sizeof(r)
+		+ (r.size & ~binary::RecordHeader::Cut) + 7) / 8 * 8;
+	    if (offset + size > end)
+	      {
+		break;
+	      }
+	    Record record =
+	      { r.timestamp, offset };
+	    records.push_back (record);
+	    offset += size;
+	  }
+      }
+    std::sort (records.begin (), records.end ());
+
+    // time stamp counter ticks can only be converted once the file has
+    // been closed and the end of the calibration is known
+    const bool tsc = header.clock == binary::TimeStampCounter;
+    const bool calibrated = !tsc
+	|| (header.closed && header.stop_ticks > header.start_ticks);
+    const double ns_per_tick =
+	tsc && calibrated ?
+	    double (header.stop_ns - header.start_ns)
+		/ double (header.stop_ticks - header.start_ticks) :
+	    1.0;
+    const std::uint64_t start = tsc ? header.start_ticks : header.start_ns;
+    std::uint64_t cut = 0;
+
+    for (const Record& record : records)
+      {
+	const unsigned char* p = map + record.offset;
+	const binary::RecordHeader r = load<binary::RecordHeader> (p);
+	if (r.size & binary::RecordHeader::Cut)
+	  {
+	    ++cut;
+	  }
+	if (times)
+	  {
+	    const double elapsed = double (r.timestamp - start);
+	    if (calibrated)
+	      {
+		char buf[32];
+		std::snprintf (buf, sizeof(buf), "time=%.9f ",
+			       elapsed * ns_per_tick * 1e-9);
+		std::cout << buf;
+	      }
+	    else
+	      {
+		std::cout << "ticks=" << r.timestamp - start << ' ';
+	      }
+	  }
+	std::cout << "threadid="
+	    << (r.thread < threads.size () ? threads[r.thread].id : "?");
+	if (r.site >= sites.size () || !sites[r.site].known)
+	  {
+	    std::cout << " unknown site " << r.site << '\n';
+	    continue;
+	  }
+	const Site& site = sites[r.site];
+	std::cout << " level=" << site.level << " file=" << site.file
+	    << " line=" << site.line << ": ";
+	const logger::FormatDescriptor descriptor =
+	  { logger::DebugLevel (site.level), site.file.c_str (), site.line,
+	      site.format.c_str (), site.types.c_str (), {} };
+	// format_deferred writes the "..." of a cut string
+	logger::format_deferred (std::cout, descriptor,
+				 p + sizeof(binary::RecordHeader),
+				 r.size & ~binary::RecordHeader::Cut);
+	std::cout << '\n';
+      }
+
+    std::cerr << records.size () << " records, " << cut << " cut, "
+	<< header.dropped_records << " dropped"
+	<< (header.closed ? "" : ", the file was not closed") << '\n';
+    return EXIT_SUCCESS;
+  }
+}
+
+int
+main (int argc, char* argv[])
+{
+  bool times = false;
+  const char* path = nullptr;
+  for (int i = 1; i < argc; ++i)
+    {
+      if (std::strcmp (argv[i], "-t") == 0)
+	{
+	  times = true;
+	}
+      else if (!path && argv[i][0] != '-')
+	{
+	  path = argv[i];
+	}
+      else
+	{
+	  path = nullptr;
+	  break;
+	}
+    }
+  if (!path)
+    {
+      std::cerr << "usage: " << argv[0] << " [-t] file\n"
+	  "writes the records as text to stdout.\n"
+	  "  -t  prefix each record with the seconds since the file was opened\n";
+      return EXIT_FAILURE;
+    }
+
+  const int fd = ::open (path, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || ::fstat (fd, &st) != 0)
+    {
+      std::perror (path);
+      return EXIT_FAILURE;
+    }
+  const std::uint64_t size = st.st_size;
+  if (size == 0)
+    {
+      std::cerr << "the file is empty\n";
+      return EXIT_FAILURE;
+    }
+  void* map = ::mmap (nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED)
+    {
+      std::perror (path);
+      return EXIT_FAILURE;
+    }
+  std::ios::sync_with_stdio (false);
+  const int ret = decode (static_cast<const unsigned char*> (map), size, times);
+  std::cout.flush ();
+  ::munmap (map, size);
+  ::close (fd);
+  return ret;
+}